@@ -24,6 +24,7 @@ public class Archigram : ModuleRules
 			new string[]
 			{
 				"Core",
+				"ArchigramRuntime",	// Shared Archigram names used in public headers, memory budget of generated content
 				// ... add other public dependencies that you statically link with here ...
 			}
 		);
@@ -41,6 +42,9 @@ public class Archigram : ModuleRules
 				"Projects",			// For getting plugin paths (icons)
 				"EditorStyle",		// For editor styling
 				"PCG",				// For triggering PCG generation on spawn
+				"DerivedDataCache",	// For caching generation results across sessions and machines
+				"AssetRegistry",	// For keying cached results by the packages the PCG graph depends on
+				"MessageLog",		// For reporting level validation results
 				// ... add private dependencies that you statically link with here ...
 			}
 		);
@@ -1,6 +1,10 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Archigram.h"
+#include "ArchigramTransaction.h"
+#include "ArchigramEditorBatch.h"
+#include "ArchigramLevelValidation.h"
+#include "ArchigramMemoryTracker.h"
 #include "ToolMenus.h"
 #include "Styling/SlateStyleRegistry.h"
 #include "Interfaces/IPluginManager.h"
@@ -11,6 +15,8 @@
 #include "UObject/ConstructorHelpers.h"
 #include "EngineUtils.h"				// For TActorIterator
 #include "Kismet/GameplayStatics.h"		// For GetAllActorsOfClass
+#include "Misc/CoreDelegates.h"
+#include "Async/Async.h"
 
 
 
@@ -24,13 +30,19 @@ const FName ArchigramStyleSetName = TEXT("ArchigramStyle");
 // Path to the BP_PCG Blueprint actor (adjust if your path is different)
 const TCHAR* FArchigramModule::PCGActorBlueprintPath = TEXT("/Archigram/Blueprints/BP_PCG.BP_PCG_C");
 
-// Folder name in World Outliner for Archigram actors
-const FName ArchigramOutlinerFolderName = FName(TEXT("Archigram"));
-
 // Static member to track the spawned PCG actor
 // TWeakObjectPtr automatically becomes invalid when the actor is deleted/garbage collected
 TWeakObjectPtr<AActor> FArchigramModule::SpawnedPCGActor = nullptr;
 
+// Generated actors and components recycled across regenerations
+FArchigramActorPool FArchigramModule::ActorPool;
+
+// Generation results restored from the Derived Data Cache
+FArchigramGenerationCache FArchigramModule::GenerationCache;
+
+// Post-generation memory budget checks per PCG component
+TMap<TWeakObjectPtr<UPCGComponent>, FDelegateHandle> FArchigramModule::MemoryBudgetWatches;
+
 #pragma endregion
 
 
@@ -52,8 +64,21 @@ void FArchigramModule::StartupModule()
 		);
 	}
 
+	// Register the message log that level validation reports to
+	FArchigramLevelValidation::RegisterMessageLog();
+
 	// Bind to map opened event to handle level changes
 	FEditorDelegates::OnMapOpened.AddRaw(this, &FArchigramModule::OnMapOpened);
+
+	// Listen for undo/redo of Archigram transactions; GEditor doesn't exist yet when loaded before the engine is initialized
+	if (GEditor)
+	{
+		RegisterUndoClient();
+	}
+	else
+	{
+		FCoreDelegates::OnPostEngineInit.AddRaw(this, &FArchigramModule::RegisterUndoClient);
+	}
 }
 
 void FArchigramModule::ShutdownModule()
@@ -61,6 +86,20 @@ void FArchigramModule::ShutdownModule()
 	// Unbind from map opened event
 	FEditorDelegates::OnMapOpened.RemoveAll(this);
 
+	// Stop listening for undo/redo of Archigram transactions
+	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+	if (GenerationUndoClient.IsValid())
+	{
+		if (GEditor)
+		{
+			GEditor->UnregisterForUndo(GenerationUndoClient.Get());
+		}
+		GenerationUndoClient.Reset();
+	}
+
+	// Unregister the level validation message log
+	FArchigramLevelValidation::UnregisterMessageLog();
+
 	// Clean up menu registrations
 	if (UToolMenus::IsToolMenuUIEnabled())
 	{
@@ -73,6 +112,21 @@ void FArchigramModule::ShutdownModule()
 
 	// Clear the PCG actor reference
 	ClearSpawnedPCGActorReference();
+
+	// Unbind pending cache stores and budget checks from PCG components that outlive the module
+	GenerationCache.Reset();
+	UnwatchMemoryBudget();
+}
+
+void FArchigramModule::RegisterUndoClient()
+{
+	if (!GEditor || GenerationUndoClient.IsValid())
+	{
+		return;
+	}
+
+	GenerationUndoClient = MakeUnique<FArchigramGenerationUndoClient>();
+	GEditor->RegisterForUndo(GenerationUndoClient.Get());
 }
 
 void FArchigramModule::RegisterStyleSet()
@@ -176,6 +230,33 @@ void FArchigramModule::RegisterMenuBarMenus()
 		FUIAction(FExecuteAction::CreateStatic(&FArchigramModule::ExecutePipelineTestLog))		// Function that the entry executes
 	);
 
+	// Add "Regenerate Layout" menu entry
+	ArchigramSection.AddMenuEntry(
+		"RegenerateLayout",
+		LOCTEXT("RegenerateLayout", "Regenerate Layout"),
+		LOCTEXT("RegenerateLayoutTooltip", "Regenerates the Archigram layout in place, reusing the existing actors"),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateLambda([]() { RegeneratePCGActor(true); }))
+	);
+
+	// Add "Validate Level" menu entry
+	ArchigramSection.AddMenuEntry(
+		"ValidateLevel",
+		LOCTEXT("ValidateLevel", "Validate Level"),
+		LOCTEXT("ValidateLevelTooltip", "Checks every Archigram actor in the level and reports problems to the Archigram message log"),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateStatic(&FArchigramModule::ExecuteValidateLevel))
+	);
+
+	// Add "Clear Layout" menu entry
+	ArchigramSection.AddMenuEntry(
+		"ClearLayout",
+		LOCTEXT("ClearLayout", "Clear Layout"),
+		LOCTEXT("ClearLayoutTooltip", "Hides the Archigram layout and keeps it pooled for the next spawn"),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateStatic(&FArchigramModule::ExecuteClearLayout))
+	);
+
 }	// end of registerMenuBarMenus
 
 void FArchigramModule::RegisterToolbarButton()
@@ -217,25 +298,26 @@ void FArchigramModule::ExecuteToolbarAction()
 	UE_LOG(LogTemp, Warning, TEXT("*  Archigram Toolbar Button Clicked!          *"));
 	UE_LOG(LogTemp, Warning, TEXT("***********************************************"));
 
-	// Check if a PCG actor already exists
+	// Coalesce the outliner and selection updates of this action into one refresh
+	FArchigramEditorUpdateBatch UpdateBatch;
+
+	// If a PCG actor already exists, regenerate it in place instead of respawning it
 	if (HasSpawnedPCGActor())
 	{
 		AActor* ExistingActor = GetSpawnedPCGActor();
-		UE_LOG(LogTemp, Warning, TEXT("Archigram: PCG Actor already exists in level: %s"), 
+		UE_LOG(LogTemp, Warning, TEXT("Archigram: PCG Actor already exists in level, regenerating: %s"), 
 			ExistingActor ? *ExistingActor->GetName() : TEXT("Unknown"));
 
+		RegeneratePCGActor(true);
+
 		if (GEngine)
 		{
 			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, 
-				TEXT("Archigram: PCG Actor already exists! Delete it first to spawn a new one."));
+				TEXT("Archigram: PCG Actor already exists, regenerated it in place."));
 		}
 
 		// Optionally select the existing actor
-		if (GEditor && ExistingActor)
-		{
-			GEditor->SelectNone(false, true);
-			GEditor->SelectActor(ExistingActor, true, true);
-		}
+		FArchigramEditorUpdateBatch::SelectActor(ExistingActor);
 		return;
 	}
 
@@ -291,25 +373,58 @@ AActor* FArchigramModule::SpawnPCGActor(FVector Location)
 		return nullptr;
 	}
 
-	// Set up spawn parameters
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	// Don't add more generated content while the level is over its Archigram memory budget
+	if (!FArchigramMemoryTracker::CheckBudget(World))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Archigram: Not spawning PCG Actor - generated content is over the memory budget"));
+		return nullptr;
+	}
+
+	// Folder move and selection of the spawned actor reach the editor UI together
+	FArchigramEditorUpdateBatch UpdateBatch;
+
+	AActor* NewActor = nullptr;
+	UPCGComponent* PCGComp = nullptr;
 
-	// Spawn the actor
-	AActor* NewActor = World->SpawnActor<AActor>(PCGActorClass, Location, FRotator::ZeroRotator, SpawnParams);
+	{
+		// One undo record for the whole spawn: the actor, its PCG inputs and the snapshot key, not the generated content.
+		// Closed before the layout is restored or generated, so the instance data never enters the transaction buffer
+		FArchigramGenerationTransaction Transaction(LOCTEXT("SpawnPCGActorTransaction", "Spawn Archigram Layout"));
+
+		// Reuse a parked actor from the pool, or spawn a new one into the "Archigram" outliner folder
+		NewActor = ActorPool.AcquireActor(World, PCGActorClass, FTransform(Location));
+		PCGComp = NewActor ? NewActor->FindComponentByClass<UPCGComponent>() : nullptr;
+
+		if (PCGComp)
+		{
+			Transaction.RecordInput(NewActor);
+			Transaction.RecordInput(PCGComp);
+			Transaction.RecordSnapshotKey(NewActor);
+		}
+	}
 
 	if (NewActor)
 	{
 		// Store the weak reference to track this actor
 		SpawnedPCGActor = NewActor;
 
-		// Place the actor in the "Archigram" folder in World Outliner
-		NewActor->SetFolderPath(ArchigramOutlinerFolderName);
-
-		if (UPCGComponent* PCGComp = NewActor->FindComponentByClass<UPCGComponent>())
+		if (PCGComp)
 		{
-			PCGComp->Generate();
-			UE_LOG(LogTemp, Log, TEXT("Archigram: Triggered PCG generation for %s"), *NewActor->GetName());
+			WatchMemoryBudget(PCGComp);
+
+			// Identical graph, dependencies, seed and spline inputs were generated before: restore instead of running the graph
+			if (GenerationCache.TryRestore(NewActor, ActorPool))
+			{
+				UE_LOG(LogTemp, Log, TEXT("Archigram: Restored cached layout for %s"), *NewActor->GetName());
+				EnforceMemoryBudget(NewActor);
+			}
+			else
+			{
+				GenerationCache.StoreOnGenerated(NewActor);
+				// Forced: a reused pooled actor may still be flagged as generated, and PCG skips those
+				PCGComp->GenerateLocal(/*bForce=*/true);
+				UE_LOG(LogTemp, Log, TEXT("Archigram: Triggered PCG generation for %s"), *NewActor->GetName());
+			}
 		}
 		else
 		{
@@ -319,12 +434,8 @@ AActor* FArchigramModule::SpawnPCGActor(FVector Location)
 		UE_LOG(LogTemp, Log, TEXT("Archigram: Successfully spawned %s at location (%f, %f, %f) in folder '%s'"), 
 			*NewActor->GetName(), Location.X, Location.Y, Location.Z, *ArchigramOutlinerFolderName.ToString());
 		
-		// Select the newly spawned actor in the editor
-		if (GEditor)
-		{
-			GEditor->SelectNone(false, true);
-			GEditor->SelectActor(NewActor, true, true);
-		}
+		// Select the newly spawned actor in the editor (deferred when called inside an update batch)
+		FArchigramEditorUpdateBatch::SelectActor(NewActor);
 	}
 	else
 	{
@@ -334,6 +445,156 @@ AActor* FArchigramModule::SpawnPCGActor(FVector Location)
 	return NewActor;
 }	// end of SpawnPCGActor
 
+bool FArchigramModule::RegeneratePCGActor(bool bTransact)
+{
+	AActor* ExistingActor = GetSpawnedPCGActor();
+	if (!ExistingActor)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Archigram: No PCG Actor to regenerate"));
+		return false;
+	}
+
+	UPCGComponent* PCGComp = ExistingActor->FindComponentByClass<UPCGComponent>();
+	if (!PCGComp)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Archigram: No PCG component found on %s"), *ExistingActor->GetName());
+		return false;
+	}
+
+	// Rebuilding after undo/redo restores an earlier state, so it isn't refused up front (the post-generation check
+	// still applies). The actor's current layout is about to be replaced, so it doesn't count against the budget
+	if (bTransact && !FArchigramMemoryTracker::CheckBudget(ExistingActor->GetWorld(), ExistingActor))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Archigram: Not regenerating %s - generated content is over the memory budget"), *ExistingActor->GetName());
+		return false;
+	}
+
+	// Record only the generation inputs and the snapshot key; undo/redo restores the content by the key.
+	// The record is closed before generating, so the generated content never enters the transaction buffer
+	if (bTransact)
+	{
+		FArchigramGenerationTransaction Transaction(LOCTEXT("RegeneratePCGActorTransaction", "Regenerate Archigram Layout"));
+		Transaction.RecordInput(ExistingActor);
+		Transaction.RecordInput(PCGComp);
+		Transaction.RecordSnapshotKey(ExistingActor);
+	}
+
+	// The actor and its components stay alive; PCG rebinds its managed resources on the new generation
+	WatchMemoryBudget(PCGComp);
+	GenerationCache.ReleaseRestored(ExistingActor, ActorPool);
+	GenerationCache.StoreOnGenerated(ExistingActor);
+	// Forced: PCG skips a non-forced generate on a component that is already generated and clean
+	PCGComp->GenerateLocal(/*bForce=*/true);
+	UE_LOG(LogTemp, Log, TEXT("Archigram: Regenerated %s in place"), *ExistingActor->GetName());
+
+	return true;
+}
+
+void FArchigramModule::WatchMemoryBudget(UPCGComponent* PCGComp)
+{
+	if (!PCGComp || MemoryBudgetWatches.Contains(PCGComp))
+	{
+		return;
+	}
+
+	const FDelegateHandle Handle = PCGComp->OnPCGGraphGeneratedDelegate.AddLambda([](UPCGComponent* GeneratedComp)
+	{
+		// Cleaning up from inside the generated broadcast would pull the resources from under PCG, so defer it
+		TWeakObjectPtr<AActor> WeakActor = GeneratedComp->GetOwner();
+		AsyncTask(ENamedThreads::GameThread, [WeakActor]()
+		{
+			EnforceMemoryBudget(WeakActor.Get());
+		});
+	});
+	MemoryBudgetWatches.Add(PCGComp, Handle);
+}
+
+void FArchigramModule::UnwatchMemoryBudget()
+{
+	for (const TPair<TWeakObjectPtr<UPCGComponent>, FDelegateHandle>& Pair : MemoryBudgetWatches)
+	{
+		if (UPCGComponent* PCGComp = Pair.Key.Get())
+		{
+			PCGComp->OnPCGGraphGeneratedDelegate.Remove(Pair.Value);
+		}
+	}
+	MemoryBudgetWatches.Empty();
+}
+
+void FArchigramModule::EnforceMemoryBudget(AActor* PCGActor)
+{
+	if (!PCGActor || FArchigramMemoryTracker::CheckBudget(PCGActor->GetWorld()))
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Error, TEXT("Archigram: Removing the layout of %s - generated content is over the memory budget"), *PCGActor->GetName());
+
+	GenerationCache.ReleaseRestored(PCGActor, ActorPool);
+	if (UPCGComponent* PCGComp = PCGActor->FindComponentByClass<UPCGComponent>())
+	{
+		PCGComp->Cleanup(/*bRemoveComponents=*/true);
+	}
+
+	// The actor no longer holds the layout its key describes
+	FArchigramGenerationCache::StampGenerationKey(PCGActor, FString());
+
+	if (GEngine)
+	{
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red,
+			FString::Printf(TEXT("Archigram: Layout of %s removed - over the memory budget"), *PCGActor->GetName()));
+	}
+}	// end of EnforceMemoryBudget
+
+void FArchigramModule::ReleasePCGActor()
+{
+	if (AActor* ExistingActor = GetSpawnedPCGActor())
+	{
+		// ReleaseActor() records the actor before hiding it, so Clear can be undone
+		FArchigramGenerationTransaction Transaction(LOCTEXT("ClearLayoutTransaction", "Clear Archigram Layout"));
+		ActorPool.ReleaseActor(ExistingActor);
+		UE_LOG(LogTemp, Log, TEXT("Archigram: Parked %s in the actor pool"), *ExistingActor->GetName());
+	}
+
+	ClearSpawnedPCGActorReference();
+}
+
+void FArchigramModule::SyncAfterUndoRedo()
+{
+	// Undo/redo may have removed, re-added, parked or unparked actors
+	ActorPool.Reconcile();
+
+	AActor* Actor = GetSpawnedPCGActor();
+	if (!IsValid(Actor) || !Actor->GetLevel() || FArchigramActorPool::IsParked(Actor))
+	{
+		// Redoing "Clear Layout" parks the active actor again
+		if (IsValid(Actor) && Actor->GetLevel())
+		{
+			ActorPool.AdoptParked(Actor);
+		}
+
+		// The active layout is gone (undone spawn) or was brought back (undone clear, redone spawn)
+		ClearSpawnedPCGActorReference();
+		Actor = FindExistingPCGActorInLevel();
+		SpawnedPCGActor = Actor;
+	}
+
+	if (Actor)
+	{
+		// The restored key stamp is the snapshot reference of this state: restore the layout from the Derived Data Cache,
+		// and only run the graph again on a cache miss
+		const FString SnapshotKey = FArchigramGenerationCache::GetGenerationKey(Actor);
+		if (!SnapshotKey.IsEmpty() && GenerationCache.TryRestoreKey(Actor, SnapshotKey, ActorPool))
+		{
+			UE_LOG(LogTemp, Log, TEXT("Archigram: Restored %s from its snapshot after undo/redo"), *Actor->GetName());
+		}
+		else
+		{
+			RegeneratePCGActor(false);
+		}
+	}
+}
+
 AActor* FArchigramModule::GetSpawnedPCGActor()
 {
 	// TWeakObjectPtr::Get() returns nullptr if the object has been destroyed
@@ -358,9 +619,18 @@ void FArchigramModule::OnMapOpened(const FString& Filename, bool bAsTemplate)
 {
 	UE_LOG(LogTemp, Log, TEXT("Archigram: Map opened - %s"), *Filename);
 
+	// Coalesce the outliner updates made while discovering Archigram actors
+	FArchigramEditorUpdateBatch UpdateBatch;
+
 	// Clear the current reference (it points to an actor in the old level)
 	ClearSpawnedPCGActorReference();
 
+	// Pooled actors, components and restored layouts belonged to the old level as well
+	// (parked actors of the new level are adopted while searching it below)
+	ActorPool.Empty();
+	GenerationCache.Reset();
+	UnwatchMemoryBudget();
+
 	// Search for existing PCG actor in the newly opened level
 	AActor* ExistingActor = FindExistingPCGActorInLevel();
 
@@ -371,12 +641,29 @@ void FArchigramModule::OnMapOpened(const FString& Filename, bool bAsTemplate)
 		// Ensure the actor is in the Archigram folder
 		if (ExistingActor->GetFolderPath() != ArchigramOutlinerFolderName)
 		{
-			ExistingActor->SetFolderPath(ArchigramOutlinerFolderName);
+			FArchigramEditorUpdateBatch::SetFolderPath(ExistingActor, ArchigramOutlinerFolderName);
 			UE_LOG(LogTemp, Log, TEXT("Archigram: Moved existing PCG Actor to 'Archigram' folder"));
 		}
 
 		UE_LOG(LogTemp, Log, TEXT("Archigram: Found existing PCG Actor in level: %s"), *ExistingActor->GetName());
 
+		// Later generations of the layout (spline edits, regenerate) are held to the memory budget
+		if (UPCGComponent* PCGComp = ExistingActor->FindComponentByClass<UPCGComponent>())
+		{
+			WatchMemoryBudget(PCGComp);
+		}
+
+		// Restored layouts are transient, so they come back from the Derived Data Cache by the key saved with the level;
+		// layouts that were never generated here are restored when someone generated the same inputs before
+		if (!FArchigramGenerationCache::IsGenerated(ExistingActor))
+		{
+			const FString SavedKey = FArchigramGenerationCache::GetGenerationKey(ExistingActor);
+			if (SavedKey.IsEmpty() ? GenerationCache.TryRestore(ExistingActor, ActorPool) : GenerationCache.TryRestoreKey(ExistingActor, SavedKey, ActorPool))
+			{
+				UE_LOG(LogTemp, Log, TEXT("Archigram: Restored cached layout for %s"), *ExistingActor->GetName());
+			}
+		}
+
 		if (GEngine)
 		{
 			GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Cyan,
@@ -387,6 +674,10 @@ void FArchigramModule::OnMapOpened(const FString& Filename, bool bAsTemplate)
 	{
 		UE_LOG(LogTemp, Log, TEXT("Archigram: No existing PCG Actor found in level"));
 	}
+
+	// Check every Archigram actor of the level off the game thread; problems go to the Archigram message log
+	UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+	FArchigramLevelValidation::RunAsync(World, LoadClass<AActor>(nullptr, PCGActorBlueprintPath));
 }
 
 AActor* FArchigramModule::FindExistingPCGActorInLevel()
@@ -413,14 +704,26 @@ AActor* FArchigramModule::FindExistingPCGActorInLevel()
 		return nullptr;
 	}
 
-	// Search for actors of this class in the world
+	// Search for actors of this class in the world; scan all of them so every parked actor is adopted
+	AActor* FoundActor = nullptr;
+
 	for (TActorIterator<AActor> It(World); It; ++It)
 	{
 		AActor* Actor = *It;
 		if (Actor && Actor->GetClass() == PCGActorClass)
 		{
+			// Actors parked by "Clear Layout" go back to the pool instead of becoming the active layout
+			if (FArchigramActorPool::IsParked(Actor))
+			{
+				ActorPool.AdoptParked(Actor);
+				continue;
+			}
+
 			// Found a matching actor
-			return Actor;
+			if (!FoundActor)
+			{
+				FoundActor = Actor;
+			}
 		}
 	}
 
@@ -432,7 +735,7 @@ AActor* FArchigramModule::FindExistingPCGActorInLevel()
 	//     return FoundActors[0];
 	// }
 
-	return nullptr;
+	return FoundActor;
 }
 
 void FArchigramModule::SetHDAMeshCollisionTypeToDefault(const FName& PackageName, EPackageFlags PackageFlags, const FString& PackageFileName, const FString& AssetPackageName)
@@ -440,6 +743,28 @@ void FArchigramModule::SetHDAMeshCollisionTypeToDefault(const FName& PackageName
 	
 }
 
+void FArchigramModule::ExecuteValidateLevel()
+{
+	UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+	FArchigramLevelValidation::RunAsync(World, LoadClass<AActor>(nullptr, PCGActorBlueprintPath));
+}
+
+void FArchigramModule::ExecuteClearLayout()
+{
+	if (!HasSpawnedPCGActor())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Archigram: No PCG Actor to clear"));
+		return;
+	}
+
+	ReleasePCGActor();
+
+	if (GEngine)
+	{
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, TEXT("Archigram: Layout cleared and pooled for reuse"));
+	}
+}
+
 void FArchigramModule::ExecutePipelineTestLog()
 {
 	// Output to the Output Log
@@ -0,0 +1,200 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ArchigramActorPool.h"
+#include "Archigram.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+#pragma region Functions
+
+AActor* FArchigramActorPool::AcquireActor(UWorld* World, UClass* ActorClass, const FTransform& Transform)
+{
+	if (!ActorClass)
+	{
+		return nullptr;
+	}
+
+	AActor* Actor = nullptr;
+
+	// Reuse a parked actor first; entries may have been deleted by the user in the meantime
+	if (TArray<TWeakObjectPtr<AActor>>* Free = FreeActors.Find(ActorClass))
+	{
+		while (!Actor && Free->Num() > 0)
+		{
+			Actor = Free->Pop().Get();
+		}
+	}
+
+	if (Actor)
+	{
+		// Recorded for undo when a transaction is open
+		Actor->Modify();
+		Actor->Tags.Remove(ArchigramParkedActorTag);
+		Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+		Actor->SetIsTemporarilyHiddenInEditor(false);
+		Actor->SetActorHiddenInGame(false);
+		Actor->SetActorEnableCollision(true);
+	}
+	else
+	{
+		if (!World)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Archigram: Cannot acquire pooled actor - no valid world found"));
+			return nullptr;
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		SpawnParams.bDeferConstruction = true;
+
+		Actor = World->SpawnActor<AActor>(ActorClass, Transform, SpawnParams);
+		if (!Actor)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Archigram: Pool failed to spawn actor of class %s"), *ActorClass->GetName());
+			return nullptr;
+		}
+
+		// Only fresh actors need a folder; reused ones already live in it. Setting it before the actor finishes
+		// spawning means the outliner adds it straight into the folder, without a separate folder-move refresh
+		Actor->SetFolderPath(ArchigramOutlinerFolderName);
+		Actor->FinishSpawning(Transform);
+	}
+
+	return Actor;
+}
+
+void FArchigramActorPool::ReleaseActor(AActor* Actor)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	// Park the actor: hidden and without collision, but still saved with the level so it is never silently dropped
+	// The tag, not the hidden state, marks the actor as parked: a user may hide a real layout as well
+	Actor->Modify();
+	Actor->Tags.AddUnique(ArchigramParkedActorTag);
+	Actor->SetIsTemporarilyHiddenInEditor(true);
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+
+	FreeActors.FindOrAdd(Actor->GetClass()).AddUnique(Actor);
+}
+
+void FArchigramActorPool::AdoptParked(AActor* Actor)
+{
+	if (!IsParked(Actor))
+	{
+		return;
+	}
+
+	// Temporary editor visibility isn't saved, so hide it again
+	Actor->SetIsTemporarilyHiddenInEditor(true);
+	FreeActors.FindOrAdd(Actor->GetClass()).AddUnique(Actor);
+}
+
+bool FArchigramActorPool::IsParked(const AActor* Actor)
+{
+	return Actor && Actor->ActorHasTag(ArchigramParkedActorTag);
+}
+
+void FArchigramActorPool::Reconcile()
+{
+	for (TPair<TObjectKey<UClass>, TArray<TWeakObjectPtr<AActor>>>& Pair : FreeActors)
+	{
+		Pair.Value.RemoveAll([](const TWeakObjectPtr<AActor>& Entry)
+		{
+			AActor* Actor = Entry.Get();
+			if (!IsValid(Actor) || !Actor->GetLevel())
+			{
+				return true;
+			}
+
+			// Undoing "Clear Layout" restores the saved visibility, but not the temporary editor one
+			if (!IsParked(Actor))
+			{
+				Actor->SetIsTemporarilyHiddenInEditor(false);
+				return true;
+			}
+			return false;
+		});
+	}
+}
+
+UActorComponent* FArchigramActorPool::AcquireComponent(AActor* Owner, UClass* ComponentClass)
+{
+	if (!Owner || !ComponentClass)
+	{
+		return nullptr;
+	}
+
+	// Reuse a parked component that belongs to the same owner
+	if (TArray<TWeakObjectPtr<UActorComponent>>* Free = FreeComponents.Find(ComponentClass))
+	{
+		for (int32 Index = Free->Num() - 1; Index >= 0; --Index)
+		{
+			UActorComponent* Component = (*Free)[Index].Get();
+			if (!Component)
+			{
+				Free->RemoveAtSwap(Index);
+				continue;
+			}
+
+			if (Component->GetOwner() == Owner)
+			{
+				Free->RemoveAtSwap(Index);
+
+				if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+				{
+					SceneComponent->SetVisibility(true);
+				}
+				Component->Activate();
+				return Component;
+			}
+		}
+	}
+
+	UActorComponent* Component = NewObject<UActorComponent>(Owner, ComponentClass, NAME_None, RF_Transient);
+	if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+	{
+		SceneComponent->SetupAttachment(Owner->GetRootComponent());
+	}
+	Owner->AddInstanceComponent(Component);
+	Component->RegisterComponent();
+
+	return Component;
+}
+
+void FArchigramActorPool::ReleaseComponent(UActorComponent* Component)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	// Drop the instance data so a parked ISM holds no render or collision state
+	if (UInstancedStaticMeshComponent* ISMComponent = Cast<UInstancedStaticMeshComponent>(Component))
+	{
+		ISMComponent->ClearInstances();
+	}
+
+	if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+	{
+		SceneComponent->SetVisibility(false);
+	}
+	Component->Deactivate();
+
+	FreeComponents.FindOrAdd(Component->GetClass()).AddUnique(Component);
+}
+
+void FArchigramActorPool::Empty()
+{
+	// Parked actors are part of the level; forgetting them leaves them in place for AdoptParked()
+	FreeActors.Empty();
+	FreeComponents.Empty();
+}
+
+#pragma endregion
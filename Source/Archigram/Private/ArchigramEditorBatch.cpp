@@ -0,0 +1,135 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ArchigramEditorBatch.h"
+#include "Editor.h"
+#include "Editor/EditorEngine.h"
+#include "Engine/Selection.h"
+#include "GameFramework/Actor.h"
+
+#pragma region Variables
+
+int32 FArchigramEditorUpdateBatch::Depth = 0;
+TMap<TWeakObjectPtr<AActor>, FName> FArchigramEditorUpdateBatch::PendingFolders;
+TArray<TWeakObjectPtr<AActor>> FArchigramEditorUpdateBatch::PendingSelection;
+bool FArchigramEditorUpdateBatch::bPendingSelectNone = false;
+
+#pragma endregion
+
+
+#pragma region Functions
+
+FArchigramEditorUpdateBatch::FArchigramEditorUpdateBatch()
+{
+	++Depth;
+}
+
+FArchigramEditorUpdateBatch::~FArchigramEditorUpdateBatch()
+{
+	if (--Depth == 0)
+	{
+		Flush();
+	}
+}
+
+void FArchigramEditorUpdateBatch::SetFolderPath(AActor* Actor, const FName& FolderPath)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	if (IsBatching())
+	{
+		PendingFolders.Add(Actor, FolderPath);
+		return;
+	}
+
+	if (Actor->GetFolderPath() != FolderPath)
+	{
+		Actor->SetFolderPath(FolderPath);
+	}
+}
+
+void FArchigramEditorUpdateBatch::SelectActor(AActor* Actor, bool bAddToSelection)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	if (IsBatching())
+	{
+		if (!bAddToSelection)
+		{
+			bPendingSelectNone = true;
+			PendingSelection.Reset();
+		}
+		PendingSelection.AddUnique(Actor);
+		return;
+	}
+
+	if (GEditor)
+	{
+		if (!bAddToSelection)
+		{
+			GEditor->SelectNone(false, true);
+		}
+		GEditor->SelectActor(Actor, true, true);
+	}
+}
+
+bool FArchigramEditorUpdateBatch::IsBatching()
+{
+	return Depth > 0;
+}
+
+void FArchigramEditorUpdateBatch::Flush()
+{
+	// Only the last requested folder per actor is applied and no-op moves are skipped;
+	// every actual move still broadcasts its own folder change
+	int32 NumMoved = 0;
+	for (const TPair<TWeakObjectPtr<AActor>, FName>& Pair : PendingFolders)
+	{
+		AActor* Actor = Pair.Key.Get();
+		if (Actor && Actor->GetFolderPath() != Pair.Value)
+		{
+			Actor->SetFolderPath(Pair.Value);
+			++NumMoved;
+		}
+	}
+	PendingFolders.Reset();
+
+	// Apply the selection with notifications suppressed, then broadcast the change once
+	int32 NumSelected = 0;
+	if (GEditor && (bPendingSelectNone || PendingSelection.Num() > 0))
+	{
+		USelection* SelectedActors = GEditor->GetSelectedActors();
+		SelectedActors->BeginBatchSelectOperation();
+
+		if (bPendingSelectNone)
+		{
+			GEditor->SelectNone(false, true);
+		}
+
+		for (const TWeakObjectPtr<AActor>& Entry : PendingSelection)
+		{
+			if (AActor* Actor = Entry.Get())
+			{
+				GEditor->SelectActor(Actor, true, false);
+				++NumSelected;
+			}
+		}
+
+		SelectedActors->EndBatchSelectOperation(false);
+		GEditor->NoteSelectionChange();
+	}
+	PendingSelection.Reset();
+	bPendingSelectNone = false;
+
+	if (NumMoved > 0 || NumSelected > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Archigram: Applied %d batched folder moves and %d selections"), NumMoved, NumSelected);
+	}
+}	// end of Flush
+
+#pragma endregion
@@ -0,0 +1,703 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ArchigramGenerationCache.h"
+#include "ArchigramActorPool.h"
+#include "ArchigramNames.h"
+#include "DerivedDataCacheInterface.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"				// For TActorIterator
+#include "GameFramework/Actor.h"
+#include "Components/SplineComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/PackageName.h"
+#include "Misc/SecureHash.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "PCGComponent.h"
+#include "PCGGraph.h"
+#include "PCGNode.h"
+#include "Elements/PCGDataFromActor.h"
+
+#pragma region Variables
+
+// Bump whenever the cached result format or the generation semantics change
+static const TCHAR* ArchigramGenerationCacheVersion = TEXT("3E8B5D1A7C4F4A92B6E0D2C8F1A7B5E3");
+
+// DDC key prefix for Archigram layouts
+static const TCHAR* ArchigramGenerationCachePrefix = TEXT("ARCHIGRAM_LAYOUT");
+
+// Component tag of the instanced mesh components TryRestore builds a cached layout from
+static const FName ArchigramRestoredComponentTag = FName(TEXT("ArchigramRestored"));
+
+// Content hashes of package files, refreshed when the file timestamp changes
+static FCriticalSection PackageHashLock;
+static TMap<FString, TPair<FDateTime, FString>> PackageHashes;
+
+#pragma endregion
+
+
+#pragma region Functions
+
+/** Content hash of a package file; safe to call from any thread */
+static FString HashPackageFile(const FString& Filename)
+{
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
+
+	{
+		FScopeLock Lock(&PackageHashLock);
+		if (const TPair<FDateTime, FString>* Cached = PackageHashes.Find(Filename))
+		{
+			if (Cached->Key == TimeStamp)
+			{
+				return Cached->Value;
+			}
+		}
+	}
+
+	const FMD5Hash Hash = FMD5Hash::HashFile(*Filename);
+	if (!Hash.IsValid())
+	{
+		return FString();
+	}
+
+	const FString HashString = LexToString(Hash);
+
+	FScopeLock Lock(&PackageHashLock);
+	PackageHashes.Add(Filename, TPair<FDateTime, FString>(TimeStamp, HashString));
+	return HashString;
+}
+
+/**
+ * File of a saved package, or an empty string if the package has unsaved changes and its file is stale.
+ * Any thread when DirtyPackages is given, game thread otherwise.
+ */
+static FString GetSavedPackageFilename(FName PackageName, const TSet<FName>* DirtyPackages)
+{
+	if (DirtyPackages)
+	{
+		if (DirtyPackages->Contains(PackageName))
+		{
+			return FString();
+		}
+	}
+	else
+	{
+		const UPackage* LoadedPackage = FindPackage(nullptr, *PackageName.ToString());
+		if (LoadedPackage && LoadedPackage->IsDirty())
+		{
+			return FString();
+		}
+	}
+
+	FString Filename;
+	if (!FPackageName::DoesPackageExist(PackageName.ToString(), &Filename))
+	{
+		return FString();
+	}
+	return Filename;
+}
+
+/**
+ * Every content package the graph depends on, directly or through the assets it references; safe to call from any thread.
+ * @return False while the asset registry is still discovering assets and the dependencies may be incomplete
+ */
+static bool GatherGraphDependencies(FName GraphPackage, TArray<FName>& OutPackages)
+{
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		return false;
+	}
+
+	TSet<FName> Visited;
+	TArray<FName> Pending;
+	Pending.Add(GraphPackage);
+
+	while (Pending.Num() > 0)
+	{
+		const FName PackageName = Pending.Pop();
+
+		bool bAlreadyVisited = false;
+		Visited.Add(PackageName, &bAlreadyVisited);
+		if (bAlreadyVisited)
+		{
+			continue;
+		}
+
+		// Native classes and engine content change with the engine version, not with the layout inputs
+		const FString PackageString = PackageName.ToString();
+		if (PackageString.StartsWith(TEXT("/Script/")) || PackageString.StartsWith(TEXT("/Engine/")))
+		{
+			continue;
+		}
+
+		OutPackages.Add(PackageName);
+		AssetRegistry.GetDependencies(PackageName, Pending, UE::AssetRegistry::EDependencyCategory::Package);
+	}
+
+	OutPackages.Sort(FNameLexicalLess());
+	return true;
+}	// end of GatherGraphDependencies
+
+/**
+ * World actors the graph reads through actor selectors (e.g. Get Spline Data selecting BP_ArchigramSpline by class), by name.
+ * Selections relative to the PCG actor itself (self, parent, root) are covered by the actor's own components.
+ */
+static void GatherSelectedActors(const UPCGGraph* Graph, const AActor* PCGActor, TArray<const AActor*>& OutActors)
+{
+	const UWorld* World = PCGActor->GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	TSet<const AActor*> Selected;
+
+	for (const UPCGNode* Node : Graph->GetNodes())
+	{
+		const UPCGDataFromActorSettings* Settings = Node ? Cast<UPCGDataFromActorSettings>(Node->GetSettings()) : nullptr;
+		if (!Settings || Settings->ActorSelector.ActorFilter != EPCGActorFilter::AllWorldActors)
+		{
+			continue;
+		}
+
+		const FPCGActorSelectorSettings& Selector = Settings->ActorSelector;
+
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			const AActor* Actor = *It;
+			const bool bMatches = (Selector.ActorSelection == EPCGActorSelection::ByClass && Selector.ActorSelectionClass && Actor->IsA(Selector.ActorSelectionClass))
+				|| (Selector.ActorSelection == EPCGActorSelection::ByTag && Actor->ActorHasTag(Selector.ActorSelectionTag));
+
+			if (bMatches && Actor != PCGActor)
+			{
+				Selected.Add(Actor);
+			}
+		}
+	}
+
+	OutActors = Selected.Array();
+	OutActors.Sort([](const AActor& A, const AActor& B) { return A.GetFName().LexicalLess(B.GetFName()); });
+}	// end of GatherSelectedActors
+
+/** Writes the spline components of an actor, in a fixed order so the bytes are stable across sessions */
+static void WriteSplines(FArchive& Writer, const AActor* Actor, ESplineCoordinateSpace::Type CoordinateSpace)
+{
+	TArray<USplineComponent*> Splines;
+	Actor->GetComponents(Splines);
+	Splines.Sort([](const USplineComponent& A, const USplineComponent& B) { return A.GetFName().LexicalLess(B.GetFName()); });
+
+	for (const USplineComponent* Spline : Splines)
+	{
+		int32 NumPoints = Spline->GetNumberOfSplinePoints();
+		bool bClosedLoop = Spline->IsClosedLoop();
+		Writer << NumPoints << bClosedLoop;
+
+		for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+		{
+			FVector Location = Spline->GetLocationAtSplinePoint(PointIndex, CoordinateSpace);
+			FVector ArriveTangent = Spline->GetArriveTangentAtSplinePoint(PointIndex, CoordinateSpace);
+			FVector LeaveTangent = Spline->GetLeaveTangentAtSplinePoint(PointIndex, CoordinateSpace);
+			FRotator Rotation = Spline->GetRotationAtSplinePoint(PointIndex, CoordinateSpace);
+			FVector Scale = Spline->GetScaleAtSplinePoint(PointIndex);
+			uint8 PointType = (uint8)Spline->GetSplinePointType(PointIndex);
+
+			Writer << Location << ArriveTangent << LeaveTangent << Rotation << Scale << PointType;
+		}
+	}
+}	// end of WriteSplines
+
+bool FArchigramGenerationInputs::Gather(const AActor* PCGActor, FArchigramGenerationInputs& OutInputs)
+{
+	if (!GatherLocal(PCGActor, OutInputs))
+	{
+		return false;
+	}
+
+	OutInputs.ResolveDependencies();
+	return true;
+}
+
+void FArchigramGenerationInputs::ResolveDependencies(const TSet<FName>* DirtyPackages)
+{
+	// Whatever the graph references (HDAs, subgraphs, meshes) feeds the layout, so all of it goes into the key
+	DependencyPackages.Reset();
+	DependencyFilenames.Reset();
+
+	TArray<FName> Dependencies;
+	if (GatherGraphDependencies(GraphPackage, Dependencies))
+	{
+		for (const FName& PackageName : Dependencies)
+		{
+			DependencyPackages.Add(PackageName.ToString());
+			DependencyFilenames.Add(GetSavedPackageFilename(PackageName, DirtyPackages));
+		}
+	}
+}
+
+bool FArchigramGenerationInputs::GatherLocal(const AActor* PCGActor, FArchigramGenerationInputs& OutInputs)
+{
+	const UPCGComponent* PCGComp = PCGActor ? PCGActor->FindComponentByClass<UPCGComponent>() : nullptr;
+	const UPCGGraph* Graph = PCGComp ? PCGComp->GetGraph() : nullptr;
+
+	if (!Graph)
+	{
+		return false;
+	}
+
+	OutInputs.GraphPath = Graph->GetPathName();
+	OutInputs.GraphPackage = Graph->GetOutermost()->GetFName();
+
+	// Resolved separately (ResolveDependencies), so callers can do it off the game thread and once per graph
+	OutInputs.DependencyPackages.Reset();
+	OutInputs.DependencyFilenames.Reset();
+
+	OutInputs.Seed = PCGComp->Seed;
+	OutInputs.ActorTransform = PCGActor->GetActorTransform();
+
+	// Spline points of the actor itself, relative to it (the actor transform is keyed separately)
+	OutInputs.SplineData.Reset();
+	FMemoryWriter Writer(OutInputs.SplineData);
+	WriteSplines(Writer, PCGActor, ESplineCoordinateSpace::Local);
+
+	// Spline actors the graph selects in the world (BP_ArchigramSpline) are separate actors: key them in world space,
+	// so editing or moving them changes the key
+	TArray<const AActor*> SelectedActors;
+	GatherSelectedActors(Graph, PCGActor, SelectedActors);
+
+	for (const AActor* SelectedActor : SelectedActors)
+	{
+		FString ActorName = SelectedActor->GetName();
+		FTransform ActorTransform = SelectedActor->GetActorTransform();
+		Writer << ActorName << ActorTransform;
+		WriteSplines(Writer, SelectedActor, ESplineCoordinateSpace::World);
+	}
+
+	return true;
+}	// end of GatherLocal
+
+FString FArchigramGenerationInputs::BuildCacheKey() const
+{
+	// Dependencies unknown (asset registry still loading): nothing to key the layout by, so don't cache
+	if (DependencyPackages.Num() == 0)
+	{
+		return FString();
+	}
+
+	TArray<uint8> KeyData;
+	FMemoryWriter Writer(KeyData);
+
+	FString GraphPathCopy = GraphPath;
+	Writer << GraphPathCopy;
+
+	for (int32 Index = 0; Index < DependencyPackages.Num(); ++Index)
+	{
+		// Unsaved dependency: the file on disk doesn't describe the inputs, so don't cache
+		if (DependencyFilenames[Index].IsEmpty())
+		{
+			return FString();
+		}
+
+		FString PackageHash = HashPackageFile(DependencyFilenames[Index]);
+		if (PackageHash.IsEmpty())
+		{
+			return FString();
+		}
+
+		FString PackageName = DependencyPackages[Index];
+		Writer << PackageName << PackageHash;
+	}
+
+	int32 SeedCopy = Seed;
+	FTransform TransformCopy = ActorTransform;
+
+	Writer << SeedCopy << TransformCopy;
+	KeyData.Append(SplineData);
+
+	FSHA1 Hasher;
+	Hasher.Update(KeyData.GetData(), KeyData.Num());
+	const FSHAHash KeyHash = Hasher.Finalize();
+
+	return FDerivedDataCacheInterface::BuildCacheKey(ArchigramGenerationCachePrefix, ArchigramGenerationCacheVersion, *KeyHash.ToString());
+}	// end of BuildCacheKey
+
+FArchive& operator<<(FArchive& Ar, FArchigramCachedMeshInstances& Instances)
+{
+	Ar << Instances.Mesh;
+	Ar << Instances.Transforms;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FArchigramGenerationResult& Result)
+{
+	Ar << Result.Meshes;
+	return Ar;
+}
+
+FArchigramGenerationResult FArchigramGenerationResult::Capture(const AActor* PCGActor)
+{
+	FArchigramGenerationResult Result;
+	if (!PCGActor)
+	{
+		return Result;
+	}
+
+	const FTransform ActorTransform = PCGActor->GetActorTransform();
+
+	TArray<UInstancedStaticMeshComponent*> ISMComponents;
+	PCGActor->GetComponents(ISMComponents);
+
+	for (const UInstancedStaticMeshComponent* ISMComponent : ISMComponents)
+	{
+		const UStaticMesh* Mesh = ISMComponent->GetStaticMesh();
+		const int32 NumInstances = ISMComponent->GetInstanceCount();
+
+		// Components of the Blueprint itself exist on every spawn, and restored ones are not PCG output;
+		// only generated ones belong to the layout
+		if (ISMComponent->CreationMethod != EComponentCreationMethod::Instance
+			|| ISMComponent->ComponentTags.Contains(ArchigramRestoredComponentTag)
+			|| !Mesh || NumInstances == 0)
+		{
+			continue;
+		}
+
+		FArchigramCachedMeshInstances& Instances = Result.Meshes.AddDefaulted_GetRef();
+		Instances.Mesh = FSoftObjectPath(Mesh);
+		Instances.Transforms.Reserve(NumInstances);
+
+		for (int32 InstanceIndex = 0; InstanceIndex < NumInstances; ++InstanceIndex)
+		{
+			FTransform InstanceTransform;
+			ISMComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
+			Instances.Transforms.Add(InstanceTransform.GetRelativeTransform(ActorTransform));
+		}
+	}
+
+	return Result;
+}	// end of Capture
+
+bool FArchigramGenerationResult::CanCapture(const AActor* PCGActor)
+{
+	if (!PCGActor)
+	{
+		return false;
+	}
+
+	// Generated components other than instanced meshes (splines, decals, HDA outputs, ...) aren't captured
+	TInlineComponentArray<UActorComponent*> Components;
+	PCGActor->GetComponents(Components);
+
+	for (const UActorComponent* Component : Components)
+	{
+		if (Component->CreationMethod == EComponentCreationMethod::Instance && !Component->IsA<UInstancedStaticMeshComponent>())
+		{
+			return false;
+		}
+	}
+
+	// Neither are actors the graph spawned: PCG attaches them to, or makes them owned by, the generating actor
+	if (const UWorld* World = PCGActor->GetWorld())
+	{
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			const AActor* Actor = *It;
+			if (Actor != PCGActor && (Actor->GetOwner() == PCGActor || Actor->IsAttachedTo(PCGActor)))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}	// end of CanCapture
+
+bool FArchigramGenerationCache::TryRestore(AActor* PCGActor, FArchigramActorPool& Pool)
+{
+	return TryRestoreKey(PCGActor, ComputeGenerationKey(PCGActor), Pool);
+}
+
+bool FArchigramGenerationCache::TryRestoreKey(AActor* PCGActor, const FString& CacheKey, FArchigramActorPool& Pool)
+{
+	if (!PCGActor || CacheKey.IsEmpty())
+	{
+		return false;
+	}
+
+	TArray<uint8> CachedData;
+	if (!GetDerivedDataCacheRef().GetSynchronous(*CacheKey, CachedData, PCGActor->GetPathName()))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Archigram: No cached layout for %s"), *PCGActor->GetName());
+		return false;
+	}
+
+	FArchigramGenerationResult Result;
+	FMemoryReader Reader(CachedData);
+	Reader << Result;
+
+	if (Reader.IsError() || Result.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Archigram: Discarding unreadable cached layout for %s"), *PCGActor->GetName());
+		return false;
+	}
+
+	// The restored layout replaces whatever was there before: an earlier restore, or PCG output
+	// (a reused pooled actor, or the newer generation an undo steps back from)
+	ReleaseRestored(PCGActor, Pool);
+	if (UPCGComponent* GeneratedComp = PCGActor->FindComponentByClass<UPCGComponent>())
+	{
+		if (GeneratedComp->bGenerated)
+		{
+			GeneratedComp->Cleanup(/*bRemoveComponents=*/true);
+		}
+	}
+	StampGenerationKey(PCGActor, CacheKey);
+
+	const FTransform ActorTransform = PCGActor->GetActorTransform();
+	int32 NumRestored = 0;
+
+	for (const FArchigramCachedMeshInstances& Instances : Result.Meshes)
+	{
+		UStaticMesh* Mesh = Cast<UStaticMesh>(Instances.Mesh.TryLoad());
+		if (!Mesh)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Archigram: Cached layout references missing mesh %s"), *Instances.Mesh.ToString());
+			continue;
+		}
+
+		UInstancedStaticMeshComponent* ISMComponent = Cast<UInstancedStaticMeshComponent>(
+			Pool.AcquireComponent(PCGActor, UInstancedStaticMeshComponent::StaticClass()));
+		if (!ISMComponent)
+		{
+			continue;
+		}
+
+		TArray<FTransform> WorldTransforms;
+		WorldTransforms.Reserve(Instances.Transforms.Num());
+		for (const FTransform& RelativeTransform : Instances.Transforms)
+		{
+			WorldTransforms.Add(RelativeTransform * ActorTransform);
+		}
+
+		// Pooled components are transient; the tag tells ReleaseRestored() and Capture() they are not PCG output
+		ISMComponent->ComponentTags.AddUnique(ArchigramRestoredComponentTag);
+		ISMComponent->SetStaticMesh(Mesh);
+		ISMComponent->AddInstances(WorldTransforms, false, true);
+		++NumRestored;
+	}
+
+	// A later PCG generation (e.g. after editing the spline) replaces the restored layout; unbound in ReleaseRestored()
+	if (UPCGComponent* PCGComp = PCGActor->FindComponentByClass<UPCGComponent>())
+	{
+		FRestoredLayout& Layout = RestoredLayouts.FindOrAdd(PCGActor);
+		Layout.PCGComponent = PCGComp;
+		Layout.StartGeneratingHandle = PCGComp->OnPCGGraphStartGeneratingDelegate.AddLambda([this, PoolPtr = &Pool](UPCGComponent* GeneratingComp)
+		{
+			ReleaseRestored(GeneratingComp->GetOwner(), *PoolPtr);
+		});
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Archigram: Restored %d cached mesh batches on %s"), NumRestored, *PCGActor->GetName());
+	return NumRestored > 0;
+}	// end of TryRestoreKey
+
+void FArchigramGenerationCache::StoreOnGenerated(AActor* PCGActor)
+{
+	UPCGComponent* PCGComp = PCGActor ? PCGActor->FindComponentByClass<UPCGComponent>() : nullptr;
+	if (!PCGComp)
+	{
+		return;
+	}
+
+	// The new generation supersedes whatever the component was generating before
+	CancelPendingStore(PCGComp);
+
+	// Key the result by the inputs the generation starts from, not what they are when it finishes
+	const FString CacheKey = ComputeGenerationKey(PCGActor);
+	if (CacheKey.IsEmpty())
+	{
+		StampGenerationKey(PCGActor, CacheKey);
+		return;
+	}
+
+	FPendingStore& Store = PendingStores.Add(PCGComp);
+	Store.CacheKey = CacheKey;
+	Store.GeneratedHandle = PCGComp->OnPCGGraphGeneratedDelegate.AddRaw(this, &FArchigramGenerationCache::OnGraphGenerated);
+	Store.CancelledHandle = PCGComp->OnPCGGraphCancelledDelegate.AddRaw(this, &FArchigramGenerationCache::OnGraphCancelled);
+}	// end of StoreOnGenerated
+
+void FArchigramGenerationCache::OnGraphGenerated(UPCGComponent* PCGComp)
+{
+	const FPendingStore* Store = PendingStores.Find(PCGComp);
+	if (!Store)
+	{
+		return;
+	}
+
+	const FString CacheKey = Store->CacheKey;
+	CancelPendingStore(PCGComp);
+
+	AActor* PCGActor = PCGComp->GetOwner();
+
+	// Inputs edited while the graph ran (spline moved, seed changed, dependency saved): the result matches neither key
+	FArchigramGenerationInputs Inputs;
+	if (!FArchigramGenerationInputs::Gather(PCGActor, Inputs) || Inputs.BuildCacheKey() != CacheKey)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Archigram: Inputs of %s changed during generation - not caching the layout"), *PCGActor->GetName());
+		StampGenerationKey(PCGActor, FString());
+		return;
+	}
+
+	StampGenerationKey(PCGActor, CacheKey);
+
+	if (!FArchigramGenerationResult::CanCapture(PCGActor))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Archigram: Layout of %s has generated output besides instanced meshes - not caching it"), *PCGActor->GetName());
+		return;
+	}
+
+	FArchigramGenerationResult Result = FArchigramGenerationResult::Capture(PCGActor);
+	if (Result.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	Writer << Result;
+
+	GetDerivedDataCacheRef().Put(*CacheKey, Data, PCGActor->GetPathName());
+	UE_LOG(LogTemp, Log, TEXT("Archigram: Cached layout of %s (%d bytes)"), *PCGActor->GetName(), Data.Num());
+}	// end of OnGraphGenerated
+
+void FArchigramGenerationCache::OnGraphCancelled(UPCGComponent* PCGComp)
+{
+	CancelPendingStore(PCGComp);
+
+	// The key was stamped up front as the snapshot reference of the layout that never got generated
+	StampGenerationKey(PCGComp->GetOwner(), FString());
+}
+
+void FArchigramGenerationCache::CancelPendingStore(UPCGComponent* PCGComp)
+{
+	FPendingStore Store;
+	if (!PendingStores.RemoveAndCopyValue(PCGComp, Store))
+	{
+		return;
+	}
+
+	if (IsValid(PCGComp))
+	{
+		PCGComp->OnPCGGraphGeneratedDelegate.Remove(Store.GeneratedHandle);
+		PCGComp->OnPCGGraphCancelledDelegate.Remove(Store.CancelledHandle);
+	}
+}
+
+void FArchigramGenerationCache::ReleaseRestored(AActor* PCGActor, FArchigramActorPool& Pool)
+{
+	if (!PCGActor)
+	{
+		return;
+	}
+
+	FRestoredLayout Layout;
+	if (RestoredLayouts.RemoveAndCopyValue(PCGActor, Layout))
+	{
+		if (UPCGComponent* PCGComp = Layout.PCGComponent.Get())
+		{
+			PCGComp->OnPCGGraphStartGeneratingDelegate.Remove(Layout.StartGeneratingHandle);
+		}
+	}
+
+	// Found by their tag rather than remembered, so nothing depends on in-memory state surviving a level reload
+	TInlineComponentArray<UInstancedStaticMeshComponent*> ISMComponents;
+	PCGActor->GetComponents(ISMComponents);
+
+	for (UInstancedStaticMeshComponent* ISMComponent : ISMComponents)
+	{
+		if (ISMComponent->ComponentTags.Contains(ArchigramRestoredComponentTag) && ISMComponent->GetInstanceCount() > 0)
+		{
+			Pool.ReleaseComponent(ISMComponent);
+		}
+	}
+}
+
+bool FArchigramGenerationCache::IsGenerated(const AActor* PCGActor)
+{
+	const UPCGComponent* PCGComp = PCGActor ? PCGActor->FindComponentByClass<UPCGComponent>() : nullptr;
+	return PCGComp && PCGComp->bGenerated;
+}
+
+FString FArchigramGenerationCache::GetGenerationKey(const AActor* PCGActor)
+{
+	if (PCGActor)
+	{
+		for (const FName& Tag : PCGActor->Tags)
+		{
+			FString TagString = Tag.ToString();
+			if (TagString.RemoveFromStart(ArchigramGenerationKeyTagPrefix))
+			{
+				return TagString;
+			}
+		}
+	}
+	return FString();
+}
+
+FString FArchigramGenerationCache::ComputeGenerationKey(const AActor* PCGActor)
+{
+	FArchigramGenerationInputs Inputs;
+	return FArchigramGenerationInputs::Gather(PCGActor, Inputs) ? Inputs.BuildCacheKey() : FString();
+}
+
+void FArchigramGenerationCache::StampGenerationKey(AActor* PCGActor, const FString& CacheKey)
+{
+	if (!PCGActor)
+	{
+		return;
+	}
+
+	if (GetGenerationKey(PCGActor) == CacheKey)
+	{
+		return;
+	}
+
+	// The stamp is saved with the level, so record it for undo and flag the level as modified
+	PCGActor->Modify();
+	PCGActor->Tags.RemoveAll([](const FName& Tag) { return Tag.ToString().StartsWith(ArchigramGenerationKeyTagPrefix); });
+
+	// An empty key only clears the stamp: the layout no longer matches any cacheable inputs
+	if (!CacheKey.IsEmpty())
+	{
+		PCGActor->Tags.Add(FName(FString(ArchigramGenerationKeyTagPrefix) + CacheKey));
+	}
+	PCGActor->MarkPackageDirty();
+}
+
+void FArchigramGenerationCache::Reset()
+{
+	// Unbind from components that may outlive the reset (module shutdown)
+	for (const TPair<TWeakObjectPtr<UPCGComponent>, FPendingStore>& Pair : PendingStores)
+	{
+		if (UPCGComponent* PCGComp = Pair.Key.Get())
+		{
+			PCGComp->OnPCGGraphGeneratedDelegate.Remove(Pair.Value.GeneratedHandle);
+			PCGComp->OnPCGGraphCancelledDelegate.Remove(Pair.Value.CancelledHandle);
+		}
+	}
+	PendingStores.Empty();
+
+	for (const TPair<TWeakObjectPtr<AActor>, FRestoredLayout>& Pair : RestoredLayouts)
+	{
+		if (UPCGComponent* PCGComp = Pair.Value.PCGComponent.Get())
+		{
+			PCGComp->OnPCGGraphStartGeneratingDelegate.Remove(Pair.Value.StartGeneratingHandle);
+		}
+	}
+	RestoredLayouts.Empty();
+}
+
+#pragma endregion
@@ -0,0 +1,259 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ArchigramLevelValidation.h"
+#include "Archigram.h"
+#include "ArchigramActorPool.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Blueprint.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"				// For TActorIterator
+#include "FileHelpers.h"				// For FEditorFileUtils::GetDirtyContentPackages
+#include "GameFramework/Actor.h"
+#include "Logging/MessageLog.h"
+#include "MessageLogModule.h"
+#include "Misc/UObjectToken.h"
+#include "PCGComponent.h"
+
+#define LOCTEXT_NAMESPACE "FArchigramLevelValidation"
+
+#pragma region Variables
+
+const FName FArchigramLevelValidation::MessageLogName = FName(TEXT("Archigram"));
+
+// Class name fragment of the Houdini Engine actor, matched by name to avoid depending on the Houdini plugin
+static const TCHAR* HoudiniAssetActorClassName = TEXT("HoudiniAssetActor");
+
+// Blueprint prefix enforced by the RightClickNamingConvention module
+static const TCHAR* BlueprintPrefix = TEXT("BP_");
+
+#pragma endregion
+
+
+#pragma region Functions
+
+void FArchigramLevelValidation::RegisterMessageLog()
+{
+	FMessageLogModule& MessageLogModule = FModuleManager::LoadModuleChecked<FMessageLogModule>("MessageLog");
+
+	FMessageLogInitializationOptions InitOptions;
+	InitOptions.bShowPages = true;
+	InitOptions.bAllowClear = true;
+
+	MessageLogModule.RegisterLogListing(MessageLogName, LOCTEXT("ArchigramMessageLogLabel", "Archigram"), InitOptions);
+}
+
+void FArchigramLevelValidation::UnregisterMessageLog()
+{
+	if (FModuleManager::Get().IsModuleLoaded("MessageLog"))
+	{
+		FMessageLogModule& MessageLogModule = FModuleManager::GetModuleChecked<FMessageLogModule>("MessageLog");
+		MessageLogModule.UnregisterLogListing(MessageLogName);
+	}
+}
+
+void FArchigramLevelValidation::RunAsync(UWorld* World, UClass* PCGActorClass)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	// Game thread: copy what the checks need into read-only snapshots
+	TArray<FArchigramActorSnapshot> Snapshots;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AActor* Actor = *It;
+		if (!Actor)
+		{
+			continue;
+		}
+
+		const bool bIsPCGActor = PCGActorClass && Actor->IsA(PCGActorClass);
+		const bool bIsHDAActor = Actor->GetClass()->GetName().Contains(HoudiniAssetActorClassName);
+		const FString GeneratedKey = FArchigramGenerationCache::GetGenerationKey(Actor);
+		const bool bInArchigramFolder = Actor->GetFolderPath() == ArchigramOutlinerFolderName
+			|| Actor->GetFolderPath().ToString().StartsWith(ArchigramOutlinerFolderName.ToString() + TEXT("/"));
+
+		if (!bIsPCGActor && !bIsHDAActor && !bInArchigramFolder && GeneratedKey.IsEmpty())
+		{
+			continue;
+		}
+
+		FArchigramActorSnapshot& Snapshot = Snapshots.AddDefaulted_GetRef();
+		Snapshot.Actor = Actor;
+		Snapshot.ActorLabel = Actor->GetActorLabel();
+		Snapshot.bIsPCGActor = bIsPCGActor;
+		Snapshot.bIsHDAActor = bIsHDAActor;
+		const UPCGComponent* PCGComp = Actor->FindComponentByClass<UPCGComponent>();
+		Snapshot.bHasPCGComponent = PCGComp != nullptr;
+		Snapshot.bPCGGenerated = PCGComp && PCGComp->bGenerated;
+		Snapshot.bIsParked = FArchigramActorPool::IsParked(Actor);
+		Snapshot.bHasInputs = FArchigramGenerationInputs::GatherLocal(Actor, Snapshot.Inputs);
+		Snapshot.GeneratedKey = GeneratedKey;
+
+		if (const UBlueprint* Blueprint = UBlueprint::GetBlueprintFromClass(Actor->GetClass()))
+		{
+			Snapshot.BlueprintName = Blueprint->GetName();
+		}
+
+		if (bIsHDAActor)
+		{
+			TArray<UStaticMeshComponent*> MeshComponents;
+			Actor->GetComponents(MeshComponents);
+
+			for (const UStaticMeshComponent* MeshComponent : MeshComponents)
+			{
+				if (MeshComponent->GetStaticMesh() && !MeshComponent->bUseDefaultCollision)
+				{
+					Snapshot.MeshesWithoutDefaultCollision.Add(MeshComponent->GetStaticMesh()->GetName());
+				}
+			}
+		}
+	}
+
+	if (Snapshots.Num() == 0)
+	{
+		return;
+	}
+
+	// Loaded packages can only be looked up on the game thread; the dependency files on disk are checked against this
+	TSet<FName> DirtyPackages;
+	{
+		TArray<UPackage*> DirtyContentPackages;
+		FEditorFileUtils::GetDirtyContentPackages(DirtyContentPackages);
+		for (const UPackage* Package : DirtyContentPackages)
+		{
+			DirtyPackages.Add(Package->GetFName());
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Archigram: Validating %d Archigram actors in the background"), Snapshots.Num());
+
+	// Thread pool: run the checks in parallel, then hand the results back to the game thread
+	Async(EAsyncExecution::ThreadPool, [Snapshots = MoveTemp(Snapshots), DirtyPackages = MoveTemp(DirtyPackages)]() mutable
+	{
+		// Walking the asset registry and the disk for the graph's dependencies is the same for every actor sharing a graph,
+		// so it runs once per graph, and only for actors the stale check needs it for
+		TMap<FName, const FArchigramGenerationInputs*> ResolvedGraphs;
+		for (FArchigramActorSnapshot& Snapshot : Snapshots)
+		{
+			if (!Snapshot.bHasInputs || Snapshot.bIsParked || Snapshot.GeneratedKey.IsEmpty())
+			{
+				continue;
+			}
+
+			if (const FArchigramGenerationInputs** Resolved = ResolvedGraphs.Find(Snapshot.Inputs.GraphPackage))
+			{
+				Snapshot.Inputs.DependencyPackages = (*Resolved)->DependencyPackages;
+				Snapshot.Inputs.DependencyFilenames = (*Resolved)->DependencyFilenames;
+			}
+			else
+			{
+				Snapshot.Inputs.ResolveDependencies(&DirtyPackages);
+				ResolvedGraphs.Add(Snapshot.Inputs.GraphPackage, &Snapshot.Inputs);
+			}
+		}
+
+		TArray<TArray<FArchigramValidationIssue>> IssuesPerActor;
+		IssuesPerActor.SetNum(Snapshots.Num());
+
+		ParallelFor(Snapshots.Num(), [&Snapshots, &IssuesPerActor](int32 Index)
+		{
+			ValidateSnapshot(Snapshots[Index], IssuesPerActor[Index]);
+		});
+
+		TArray<FArchigramValidationIssue> Issues;
+		for (TArray<FArchigramValidationIssue>& ActorIssues : IssuesPerActor)
+		{
+			Issues.Append(MoveTemp(ActorIssues));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [Issues = MoveTemp(Issues), NumValidated = Snapshots.Num()]()
+		{
+			Report(Issues, NumValidated);
+		});
+	});
+}	// end of RunAsync
+
+void FArchigramLevelValidation::ValidateSnapshot(const FArchigramActorSnapshot& Snapshot, TArray<FArchigramValidationIssue>& OutIssues)
+{
+	const FText Label = FText::FromString(Snapshot.ActorLabel);
+
+	auto AddIssue = [&Snapshot, &OutIssues](const FText& Message)
+	{
+		OutIssues.Add({ Snapshot.Actor, Message });
+	};
+
+	// Missing PCG component: a BP_PCG actor that can never generate
+	if (Snapshot.bIsPCGActor && !Snapshot.bHasPCGComponent)
+	{
+		AddIssue(FText::Format(LOCTEXT("MissingPCGComponent", "{0} has no PCG component and cannot generate its layout"), Label));
+	}
+
+	// Stale generation: the inputs changed since the layout was generated.
+	// Parked pool actors are not part of the layout, so whatever they still hold doesn't matter
+	if (Snapshot.bHasPCGComponent && Snapshot.bHasInputs && !Snapshot.bIsParked)
+	{
+		// Layouts restored from cache always carry a key, so without one only the PCG component's state counts
+		if (Snapshot.GeneratedKey.IsEmpty())
+		{
+			if (!Snapshot.bPCGGenerated)
+			{
+				AddIssue(FText::Format(LOCTEXT("NeverGenerated", "{0} has not been generated"), Label));
+			}
+		}
+		else
+		{
+			// Hashing the package files the graph depends on is the expensive part, which is why this runs off the game thread
+			const FString CurrentKey = Snapshot.Inputs.BuildCacheKey();
+			if (!CurrentKey.IsEmpty() && CurrentKey != Snapshot.GeneratedKey)
+			{
+				AddIssue(FText::Format(LOCTEXT("StaleGeneration", "{0} is stale: its graph, HDA, seed or spline changed since it was generated"), Label));
+			}
+		}
+	}
+
+	// Wrong collision: HDA meshes are expected to use their mesh's default collision
+	for (const FString& MeshName : Snapshot.MeshesWithoutDefaultCollision)
+	{
+		AddIssue(FText::Format(LOCTEXT("HDAMeshCollision", "{0}: HDA mesh {1} does not use the Default collision preset"), Label, FText::FromString(MeshName)));
+	}
+
+	// Naming convention: Archigram blueprints follow the BP_ prefix
+	if (!Snapshot.BlueprintName.IsEmpty() && !Snapshot.BlueprintName.StartsWith(BlueprintPrefix))
+	{
+		AddIssue(FText::Format(LOCTEXT("NamingConvention", "{0}: blueprint {1} does not follow the {2} naming convention"),
+			Label, FText::FromString(Snapshot.BlueprintName), FText::FromString(BlueprintPrefix)));
+	}
+}	// end of ValidateSnapshot
+
+void FArchigramLevelValidation::Report(const TArray<FArchigramValidationIssue>& Issues, int32 NumValidated)
+{
+	FMessageLog MessageLog(MessageLogName);
+	MessageLog.NewPage(LOCTEXT("ValidationPage", "Level Validation"));
+
+	for (const FArchigramValidationIssue& Issue : Issues)
+	{
+		TSharedRef<FTokenizedMessage> Message = MessageLog.Warning();
+		if (AActor* Actor = Issue.Actor.Get())
+		{
+			Message->AddToken(FUObjectToken::Create(Actor));
+		}
+		Message->AddToken(FTextToken::Create(Issue.Message));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Archigram: Validated %d Archigram actors, %d issues found"), NumValidated, Issues.Num());
+
+	if (Issues.Num() > 0)
+	{
+		MessageLog.Notify(FText::Format(LOCTEXT("ValidationNotify", "Archigram: {0} issues found in the level"), Issues.Num()), EMessageSeverity::Warning);
+	}
+}
+
+#pragma endregion
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ArchigramTransaction.h"
+#include "Archigram.h"
+#include "ArchigramGenerationCache.h"
+
+#pragma region Variables
+
+const TCHAR* FArchigramGenerationTransaction::TransactionContext = TEXT("ArchigramGeneration");
+
+#pragma endregion
+
+
+#pragma region Functions
+
+FArchigramGenerationTransaction::FArchigramGenerationTransaction(const FText& Description)
+	: Transaction(TransactionContext, Description, nullptr)
+{
+}
+
+void FArchigramGenerationTransaction::RecordInput(UObject* Object)
+{
+	if (Object)
+	{
+		Object->Modify();
+	}
+}
+
+void FArchigramGenerationTransaction::RecordSnapshotKey(AActor* PCGActor)
+{
+	// Stamping records the actor itself when the key changes
+	if (PCGActor)
+	{
+		FArchigramGenerationCache::StampGenerationKey(PCGActor, FArchigramGenerationCache::ComputeGenerationKey(PCGActor));
+	}
+}
+
+bool FArchigramGenerationUndoClient::MatchesContext(const FTransactionContext& InContext, const TArray<TPair<UObject*, FTransactionObjectEvent>>& TransactionObjectContexts) const
+{
+	return InContext.Context == FArchigramGenerationTransaction::TransactionContext;
+}
+
+void FArchigramGenerationUndoClient::PostUndo(bool bSuccess)
+{
+	if (bSuccess)
+	{
+		FArchigramModule::SyncAfterUndoRedo();
+	}
+}
+
+void FArchigramGenerationUndoClient::PostRedo(bool bSuccess)
+{
+	PostUndo(bSuccess);
+}
+
+#pragma endregion
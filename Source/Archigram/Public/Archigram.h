@@ -7,6 +7,11 @@
 #include "Styling/SlateStyle.h"
 #include "UObject/WeakObjectPtrTemplates.h"
 #include "PCGComponent.h"
+#include "ArchigramActorPool.h"
+#include "ArchigramGenerationCache.h"
+#include "ArchigramNames.h"
+
+class FArchigramGenerationUndoClient;
 
 class FArchigramModule : public IModuleInterface
 {
@@ -41,6 +46,26 @@ public:
 	 */
 	static void ClearSpawnedPCGActorReference();
 
+	/**
+	 * Regenerates the spawned PCG actor in place instead of destroying and respawning it.
+	 * @param bTransact - Wrap the regeneration in a single undo record (false when rebuilding after undo/redo)
+	 * @return True if a PCG actor existed and generation was triggered
+	 */
+	static bool RegeneratePCGActor(bool bTransact = true);
+
+	/**
+	 * Parks the spawned PCG actor in the actor pool so the next spawn reuses it.
+	 * Recorded as a single undoable "Clear Archigram Layout" transaction.
+	 */
+	static void ReleasePCGActor();
+
+	/**
+	 * Called after an Archigram transaction is undone or redone.
+	 * Drops references to actors the undo removed or parked, picks up the active layout again and
+	 * restores its generated content from the restored snapshot key (regenerating it on a cache miss).
+	 */
+	static void SyncAfterUndoRedo();
+
 private:
 	/** Register custom Slate style (icons) */
 	void RegisterStyleSet();
@@ -52,12 +77,24 @@ private:
 	/** Register main toolbar button */
 	void RegisterToolbarButton();
 
+	/** Register the undo/redo listener for Archigram transactions (needs GEditor) */
+	void RegisterUndoClient();
+
+	/** Rebuilds the layout after undo/redo of an Archigram transaction */
+	TUniquePtr<FArchigramGenerationUndoClient> GenerationUndoClient;
+
 	/** Test function that outputs to log */
 	static void ExecutePipelineTestLog();
 
-	/** Toolbar button action - spawns the PCG actor */
+	/** Menu action - validates every Archigram actor of the current level in the background */
+	static void ExecuteValidateLevel();
+
+	/** Toolbar button action - spawns the PCG actor, or regenerates it if it already exists */
 	static void ExecuteToolbarAction();
 
+	/** Menu action - parks the PCG actor in the pool */
+	static void ExecuteClearLayout();
+
 	/** Custom style set for icons */
 	TSharedPtr<FSlateStyleSet> StyleSet;
 
@@ -70,6 +107,25 @@ private:
 	 */
 	static TWeakObjectPtr<AActor> SpawnedPCGActor;
 
+	/** Generated actors and components recycled across regenerations */
+	static FArchigramActorPool ActorPool;
+
+	/** Generation results stored in and restored from the Derived Data Cache */
+	static FArchigramGenerationCache GenerationCache;
+
+	/** Budget checks bound to OnPCGGraphGeneratedDelegate, one per PCG component */
+	static TMap<TWeakObjectPtr<UPCGComponent>, FDelegateHandle> MemoryBudgetWatches;
+
+	/** Checks the memory budget again every time the component finishes generating (bound once per component) */
+	static void WatchMemoryBudget(UPCGComponent* PCGComp);
+	static void UnwatchMemoryBudget();
+
+	/**
+	 * Budget check once new content is in the level; the pre-generation check only sees the old layout.
+	 * Removes the actor's layout again when archigram.Memory.RefuseOverBudget is set and the budget is exceeded.
+	 */
+	static void EnforceMemoryBudget(AActor* PCGActor);
+
 	/** 
 	 * Called when a map/level is opened in the editor.
 	 * Clears current reference and searches for existing PCG actor in the new level.
@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AActor;
+class UActorComponent;
+class UWorld;
+
+/**
+ * Keeps generated actors and components per class alive across regenerations.
+ * Released objects are hidden and parked instead of destroyed, and get rebound to a new
+ * transform the next time they are acquired.
+ * Parked actors stay in the level (hidden, no collision, tagged with ArchigramParkedActorTag), so saving
+ * never drops them; they are picked up again with AdoptParked() when the level is reopened.
+ */
+class FArchigramActorPool
+{
+public:
+	/**
+	 * Returns a parked actor of the given class moved to Transform, or spawns a new one if none is free.
+	 * Newly spawned actors are placed in the Archigram outliner folder.
+	 * @param World - World to spawn into when the pool is empty
+	 * @param ActorClass - Class to acquire
+	 * @param Transform - Transform the actor is rebound to
+	 * @return The acquired actor, or nullptr if spawning failed
+	 */
+	AActor* AcquireActor(UWorld* World, UClass* ActorClass, const FTransform& Transform);
+
+	/** Hides the actor and parks it in the pool instead of destroying it */
+	void ReleaseActor(AActor* Actor);
+
+	/** Registers an actor that was parked in an earlier session (found when the level is opened) */
+	void AdoptParked(AActor* Actor);
+
+	/** True if the actor was parked by ReleaseActor() (carries ArchigramParkedActorTag) */
+	static bool IsParked(const AActor* Actor);
+
+	/** Drops parked entries that undo/redo removed from the level or unparked */
+	void Reconcile();
+
+	/**
+	 * Returns a parked component of the given class on Owner, or creates and registers a new one.
+	 * New components are transient: they are never saved with the level or recorded in undo transactions.
+	 * Callers are expected to rebind the component parameters (mesh, instances, ...) after acquiring.
+	 */
+	UActorComponent* AcquireComponent(AActor* Owner, UClass* ComponentClass);
+
+	/** Hides and deactivates the component and parks it in the pool instead of destroying it */
+	void ReleaseComponent(UActorComponent* Component);
+
+	/** Forgets every parked actor and component (their level was closed); nothing is destroyed */
+	void Empty();
+
+private:
+	/** Hidden actors waiting to be reused, per class */
+	TMap<TObjectKey<UClass>, TArray<TWeakObjectPtr<AActor>>> FreeActors;
+
+	/** Hidden components waiting to be reused, per component class */
+	TMap<TObjectKey<UClass>, TArray<TWeakObjectPtr<UActorComponent>>> FreeComponents;
+};
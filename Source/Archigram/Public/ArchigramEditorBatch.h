@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AActor;
+
+/**
+ * Defers outliner folder moves and selection changes made by Archigram editor flows.
+ * While at least one batch is open, SetFolderPath() and SelectActor() only queue the change; the outermost
+ * batch applies them on destruction. Folder moves are deduplicated per actor and skipped when the actor is
+ * already in place, but each remaining move still sends its own folder notification; only the selection
+ * changes are merged into a single selection-changed notification.
+ * Freshly spawned layout actors don't go through SetFolderPath(): the actor pool sets their folder before
+ * they finish spawning, so a spawn sends no folder-move notification at all.
+ * Without an open batch the changes are applied immediately.
+ */
+class FArchigramEditorUpdateBatch
+{
+public:
+	FArchigramEditorUpdateBatch();
+	~FArchigramEditorUpdateBatch();
+
+	FArchigramEditorUpdateBatch(const FArchigramEditorUpdateBatch&) = delete;
+	FArchigramEditorUpdateBatch& operator=(const FArchigramEditorUpdateBatch&) = delete;
+
+	/** Moves the actor to the outliner folder (no-op if it is already there) */
+	static void SetFolderPath(AActor* Actor, const FName& FolderPath);
+
+	/**
+	 * Selects the actor in the editor.
+	 * @param bAddToSelection - Keep the current selection instead of replacing it
+	 */
+	static void SelectActor(AActor* Actor, bool bAddToSelection = false);
+
+	/** True while a batch is open */
+	static bool IsBatching();
+
+private:
+	/** Applies the queued folder moves (one per actor) and the selection (one notification) */
+	static void Flush();
+
+	/** Number of nested batches currently open */
+	static int32 Depth;
+
+	/** Last requested folder per actor */
+	static TMap<TWeakObjectPtr<AActor>, FName> PendingFolders;
+
+	/** Actors to select on flush, in request order */
+	static TArray<TWeakObjectPtr<AActor>> PendingSelection;
+
+	/** Whether the selection should be cleared before PendingSelection is applied */
+	static bool bPendingSelectNone;
+};
@@ -0,0 +1,173 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AActor;
+class UActorComponent;
+class UPCGComponent;
+class FArchigramActorPool;
+
+/**
+ * Everything a BP_PCG generation depends on.
+ * GatherLocal() captures the cheap part on the game thread; resolving the graph's dependencies and building the
+ * cache key only query the asset registry and touch files on disk, so they can run on any thread.
+ */
+struct FArchigramGenerationInputs
+{
+	/** PCG graph asset and its package */
+	FString GraphPath;
+	FName GraphPackage;
+
+	/**
+	 * Content packages the graph references, directly or through other assets (the graph itself, subgraphs, HDAs, meshes),
+	 * sorted by name, and the package files they were loaded from (empty if the package has unsaved changes)
+	 */
+	TArray<FString> DependencyPackages;
+	TArray<FString> DependencyFilenames;
+
+	/** PCG component seed */
+	int32 Seed = 0;
+
+	/**
+	 * Actor transform, and spline points of the actor's own spline components followed by those of the
+	 * world actors the graph selects (e.g. BP_ArchigramSpline read by Get Spline Data)
+	 */
+	FTransform ActorTransform;
+	TArray<uint8> SplineData;
+
+	/**
+	 * Reads the generation inputs of a BP_PCG actor, dependencies included; game thread only.
+	 * @return False if the actor has no PCG component or graph
+	 */
+	static bool Gather(const AActor* PCGActor, FArchigramGenerationInputs& OutInputs);
+
+	/** Reads the graph, seed, transform and spline data, leaving the dependencies unresolved; game thread only */
+	static bool GatherLocal(const AActor* PCGActor, FArchigramGenerationInputs& OutInputs);
+
+	/**
+	 * Walks the asset registry for the packages the graph depends on and finds their files on disk.
+	 * @param DirtyPackages - Packages with unsaved changes, snapshotted on the game thread. When given, this runs on
+	 *                        any thread; without it loaded packages are looked up, which is game thread only
+	 */
+	void ResolveDependencies(const TSet<FName>* DirtyPackages = nullptr);
+
+	/** Stable Derived Data Cache key for these inputs (hashes of the graph and its dependencies, seed, spline data) */
+	FString BuildCacheKey() const;
+};
+
+/** Instances of one mesh in a generated layout, relative to the BP_PCG actor */
+struct FArchigramCachedMeshInstances
+{
+	FSoftObjectPath Mesh;
+	TArray<FTransform> Transforms;
+
+	friend FArchive& operator<<(FArchive& Ar, FArchigramCachedMeshInstances& Instances);
+};
+
+/** Generation result of one BP_PCG actor as stored in the Derived Data Cache */
+struct FArchigramGenerationResult
+{
+	TArray<FArchigramCachedMeshInstances> Meshes;
+
+	/** Collects the instanced meshes currently generated on the actor */
+	static FArchigramGenerationResult Capture(const AActor* PCGActor);
+
+	/**
+	 * True if Capture() covers everything the last generation produced: no spawned or attached actors,
+	 * and no generated components other than instanced static meshes.
+	 * Only complete results are cached, because a cache hit skips the PCG graph entirely.
+	 */
+	static bool CanCapture(const AActor* PCGActor);
+
+	bool IsEmpty() const { return Meshes.Num() == 0; }
+
+	friend FArchive& operator<<(FArchive& Ar, FArchigramGenerationResult& Result);
+};
+
+/**
+ * Stores generation results in the Derived Data Cache keyed by FArchigramGenerationInputs,
+ * so identical inputs are restored instead of regenerated (shared DDC lets the whole team skip generation).
+ */
+class FArchigramGenerationCache
+{
+public:
+	/**
+	 * Restores a cached layout onto the actor using pooled, transient instanced mesh components.
+	 * @return True on a cache hit, in which case the PCG graph does not need to run
+	 */
+	bool TryRestore(AActor* PCGActor, FArchigramActorPool& Pool);
+
+	/**
+	 * Restores the layout stored under CacheKey, whatever the actor's current inputs are.
+	 * Used after undo/redo, where the restored key stamp is the snapshot reference of the layout.
+	 * Output of an earlier PCG generation on the actor is cleaned up first.
+	 * @return True on a cache hit
+	 */
+	bool TryRestoreKey(AActor* PCGActor, const FString& CacheKey, FArchigramActorPool& Pool);
+
+	/**
+	 * Stores the layout after the next generation of the actor's PCG component finishes.
+	 * Replaces a store still pending on the same component; a cancelled generation drops it.
+	 */
+	void StoreOnGenerated(AActor* PCGActor);
+
+	/** Returns the components restored from cache on the actor to the pool (before a real generation) */
+	void ReleaseRestored(AActor* PCGActor, FArchigramActorPool& Pool);
+
+	/**
+	 * True if the actor's PCG component holds a generated layout.
+	 * Restored layouts are transient and don't count: they are restored again after the level is loaded.
+	 */
+	static bool IsGenerated(const AActor* PCGActor);
+
+	/**
+	 * Cache key of the inputs the actor's current layout was generated from (stored as an actor tag).
+	 * Stamping records the actor for undo and dirties its package when the key changes.
+	 */
+	static FString GetGenerationKey(const AActor* PCGActor);
+	static void StampGenerationKey(AActor* PCGActor, const FString& CacheKey);
+
+	/** Cache key of the actor's current generation inputs, or an empty string if they can't be cached */
+	static FString ComputeGenerationKey(const AActor* PCGActor);
+
+	/** Forgets the restored components and pending stores (their level was closed) */
+	void Reset();
+
+private:
+	/** Store waiting for a generation of one PCG component to finish */
+	struct FPendingStore
+	{
+		/** Key of the inputs the generation started from */
+		FString CacheKey;
+
+		FDelegateHandle GeneratedHandle;
+		FDelegateHandle CancelledHandle;
+	};
+
+	/**
+	 * Layout restored by TryRestore on one BP_PCG actor. The restored components themselves carry a component tag
+	 * and are found by it, so only the delegate binding is kept here.
+	 */
+	struct FRestoredLayout
+	{
+		/** Releases the layout when the PCG component starts a real generation */
+		TWeakObjectPtr<UPCGComponent> PCGComponent;
+		FDelegateHandle StartGeneratingHandle;
+	};
+
+	void OnGraphGenerated(UPCGComponent* PCGComp);
+	void OnGraphCancelled(UPCGComponent* PCGComp);
+
+	/** Unbinds and forgets the store pending on the component, if any */
+	void CancelPendingStore(UPCGComponent* PCGComp);
+
+	/** At most one pending store per PCG component */
+	TMap<TWeakObjectPtr<UPCGComponent>, FPendingStore> PendingStores;
+
+	/** Restored layouts waiting for a real generation, per BP_PCG actor */
+	TMap<TWeakObjectPtr<AActor>, FRestoredLayout> RestoredLayouts;
+};
@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "ArchigramGenerationCache.h"
+
+class AActor;
+class UWorld;
+
+/** Read-only copy of everything the validation needs to know about one Archigram actor */
+struct FArchigramActorSnapshot
+{
+	TWeakObjectPtr<AActor> Actor;		// only dereferenced back on the game thread for the report
+	FString ActorLabel;
+	FString BlueprintName;
+
+	bool bIsPCGActor = false;
+	bool bIsHDAActor = false;
+	bool bHasPCGComponent = false;
+	bool bPCGGenerated = false;		// the PCG component's own generated state
+	bool bIsParked = false;			// parked in the actor pool by "Clear Layout"
+
+	/**
+	 * Generation inputs now (dependencies resolved on the worker, once per graph), and the cache key
+	 * stamped when the layout was last generated
+	 */
+	bool bHasInputs = false;
+	FArchigramGenerationInputs Inputs;
+	FString GeneratedKey;
+
+	/** HDA mesh components that don't use the mesh's default collision */
+	TArray<FString> MeshesWithoutDefaultCollision;
+};
+
+/** One problem found by the validation pass */
+struct FArchigramValidationIssue
+{
+	TWeakObjectPtr<AActor> Actor;
+	FText Message;
+};
+
+/**
+ * Validates every Archigram actor of a level in parallel.
+ * Snapshots are taken on the game thread; the checks (including hashing the generation inputs) run on the
+ * thread pool and the results are reported to the "Archigram" message log back on the game thread.
+ */
+class FArchigramLevelValidation
+{
+public:
+	/** Name of the message log listing the results are reported to */
+	static const FName MessageLogName;
+
+	/** Registers / unregisters the "Archigram" message log listing */
+	static void RegisterMessageLog();
+	static void UnregisterMessageLog();
+
+	/**
+	 * Snapshots the Archigram actors of the world and starts validating them off the game thread.
+	 * @param World - World to validate
+	 * @param PCGActorClass - BP_PCG class; actors of this class must carry a PCG component
+	 */
+	static void RunAsync(UWorld* World, UClass* PCGActorClass);
+
+private:
+	/** Runs every check on one snapshot; safe to call from any thread */
+	static void ValidateSnapshot(const FArchigramActorSnapshot& Snapshot, TArray<FArchigramValidationIssue>& OutIssues);
+
+	/** Writes the issues to the message log; game thread only */
+	static void Report(const TArray<FArchigramValidationIssue>& Issues, int32 NumValidated);
+};
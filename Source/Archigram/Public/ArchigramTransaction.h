@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScopedTransaction.h"
+#include "EditorUndoClient.h"
+
+/**
+ * Wraps one Archigram layout operation (spawn, regenerate, clear) in a single undo record.
+ * Only actors spawned inside the scope, the objects passed to RecordInput() and the snapshot key are recorded.
+ * Callers close the scope before restoring or generating the layout, so generated content never enters the
+ * transaction buffer; undo/redo restores it from the snapshot key instead (see FArchigramGenerationUndoClient).
+ */
+class FArchigramGenerationTransaction
+{
+public:
+	/** Transaction context shared by every Archigram layout record */
+	static const TCHAR* TransactionContext;
+
+	explicit FArchigramGenerationTransaction(const FText& Description);
+
+	/** Records an object that drives the layout (PCG actor, PCG component) */
+	void RecordInput(UObject* Object);
+
+	/**
+	 * Stamps the cache key of the actor's current inputs as the snapshot reference of the layout about to be built.
+	 * Undo/redo brings back the key of the matching state, and the layout is restored from the Derived Data Cache by it.
+	 */
+	void RecordSnapshotKey(AActor* PCGActor);
+
+private:
+	FScopedTransaction Transaction;
+};
+
+/**
+ * Brings the Archigram module back in step after one of its records is undone or redone:
+ * the restored inputs may belong to a removed, re-added, parked or unparked actor, and the
+ * generated content has to be restored from the snapshot key (or regenerated on a cache miss).
+ * Owned by FArchigramModule, registered in StartupModule and unregistered in ShutdownModule.
+ */
+class FArchigramGenerationUndoClient : public FEditorUndoClient
+{
+public:
+	virtual bool MatchesContext(const FTransactionContext& InContext, const TArray<TPair<UObject*, FTransactionObjectEvent>>& TransactionObjectContexts) const override;
+	virtual void PostUndo(bool bSuccess) override;
+	virtual void PostRedo(bool bSuccess) override;
+};
@@ -38,6 +38,7 @@ public class ArchigramEditor : ModuleRules
 				"SlateCore",
 				"UnrealEd",
 				"ArchigramRuntime",		// editor can depend on runtime
+				"WorkspaceMenuStructure",	// place the memory panel in the Window menu
 				// ... add private dependencies that you statically link with here ...
 			}
 		);
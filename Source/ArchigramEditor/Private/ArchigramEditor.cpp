@@ -1,19 +1,50 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ArchigramEditor.h"
+#include "SArchigramMemoryPanel.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Docking/TabManager.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "WorkspaceMenuStructure.h"
+#include "WorkspaceMenuStructureModule.h"
 
 #define LOCTEXT_NAMESPACE "FArchigramEditorModule"
 
+// Tab id of the Archigram memory panel
+static const FName ArchigramMemoryPanelTabName = FName(TEXT("ArchigramMemoryPanel"));
+
 void FArchigramEditorModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	// LoadingPhase is PostEngineInit, so the engine is fully initialized when this runs
+
+	// Register the memory panel under Window > Level Editor
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(
+		ArchigramMemoryPanelTabName,
+		FOnSpawnTab::CreateRaw(this, &FArchigramEditorModule::SpawnMemoryPanelTab))
+		.SetDisplayName(LOCTEXT("ArchigramMemoryPanelTitle", "Archigram Memory"))
+		.SetTooltipText(LOCTEXT("ArchigramMemoryPanelTooltip", "Memory used by generated Archigram content, per actor and layout cell"))
+		.SetGroup(WorkspaceMenu::GetMenuStructure().GetLevelEditorCategory());
 }
 
 void FArchigramEditorModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module. For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+
+	if (FSlateApplication::IsInitialized())
+	{
+		FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(ArchigramMemoryPanelTabName);
+	}
+}
+
+TSharedRef<SDockTab> FArchigramEditorModule::SpawnMemoryPanelTab(const FSpawnTabArgs& Args)
+{
+	return SNew(SDockTab)
+		.TabRole(ETabRole::NomadTab)
+		[
+			SNew(SArchigramMemoryPanel)
+		];
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SArchigramMemoryPanel.h"
+#include "ArchigramMemoryTracker.h"
+#include "Editor.h"
+#include "Styling/CoreStyle.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Text/STextBlock.h"
+
+#define LOCTEXT_NAMESPACE "SArchigramMemoryPanel"
+
+void SArchigramMemoryPanel::Construct(const FArguments& InArgs)
+{
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(4.0f)
+		[
+			SNew(SButton)
+			.Text(LOCTEXT("RefreshButton", "Refresh"))
+			.ToolTipText(LOCTEXT("RefreshButtonTooltip", "Measure the Archigram actors of the current level again"))
+			.OnClicked(this, &SArchigramMemoryPanel::OnRefreshClicked)
+		]
+
+		+ SVerticalBox::Slot()
+		.FillHeight(1.0f)
+		.Padding(4.0f)
+		[
+			SNew(SScrollBox)
+			+ SScrollBox::Slot()
+			[
+				SAssignNew(ReportText, STextBlock)
+				.Font(FCoreStyle::GetDefaultFontStyle("Mono", 9))		// monospace keeps the report columns aligned
+			]
+		]
+	];
+
+	RefreshReport();
+}
+
+FReply SArchigramMemoryPanel::OnRefreshClicked()
+{
+	RefreshReport();
+	return FReply::Handled();
+}
+
+void SArchigramMemoryPanel::RefreshReport()
+{
+	UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+	const FArchigramMemoryReport Report = FArchigramMemoryTracker::BuildReport(World);
+
+	ReportText->SetText(FText::FromString(Report.ToString()));
+	ReportText->SetColorAndOpacity(Report.IsOverBudget() ? FSlateColor(FLinearColor::Red) : FSlateColor::UseForeground());
+}
+
+#undef LOCTEXT_NAMESPACE
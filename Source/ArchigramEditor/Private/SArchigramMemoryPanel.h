@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+
+class STextBlock;
+
+/** Editor panel showing the memory attributed to each Archigram actor and layout cell of the editor world */
+class SArchigramMemoryPanel : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SArchigramMemoryPanel) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+private:
+	/** Rebuilds the report from the current editor world */
+	FReply OnRefreshClicked();
+	void RefreshReport();
+
+	/** Report text, one line per actor and per cell */
+	TSharedPtr<STextBlock> ReportText;
+};
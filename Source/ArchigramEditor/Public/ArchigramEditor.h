@@ -12,4 +12,8 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	/** Spawns the Archigram memory panel tab */
+	TSharedRef<class SDockTab> SpawnMemoryPanelTab(const class FSpawnTabArgs& Args);
 };
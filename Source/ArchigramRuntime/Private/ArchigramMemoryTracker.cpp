@@ -0,0 +1,294 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ArchigramMemoryTracker.h"
+#include "ArchigramNames.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"				// For TActorIterator
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "PhysicsEngine/BodySetup.h"
+
+#pragma region Variables
+
+static TAutoConsoleVariable<int32> CVarArchigramMemoryBudgetMB(
+	TEXT("archigram.Memory.BudgetMB"),
+	0,
+	TEXT("Memory budget of all generated Archigram content in the world, in MB. 0 disables the budget."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarArchigramMemoryRefuseOverBudget(
+	TEXT("archigram.Memory.RefuseOverBudget"),
+	0,
+	TEXT("0: only warn when Archigram content is over budget. 1: refuse to start new generations while over budget."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarArchigramMemoryCellSize(
+	TEXT("archigram.Memory.CellSize"),
+	25600.0f,
+	TEXT("Size in cm of the layout cells Archigram memory is aggregated into."),
+	ECVF_Default);
+
+static constexpr double BytesPerMB = 1024.0 * 1024.0;
+
+#pragma endregion
+
+
+#pragma region Functions
+
+/** Mesh and render data of a static mesh; its collision is counted separately from the body setup */
+static SIZE_T GetMeshBytes(UStaticMesh* Mesh)
+{
+	return Mesh->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+}
+
+/** Collision of a static mesh, shared by every component using the mesh */
+static SIZE_T GetBodySetupBytes(UStaticMesh* Mesh)
+{
+	UBodySetup* BodySetup = Mesh->GetBodySetup();
+	return BodySetup ? BodySetup->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) : 0;
+}
+
+/** Layout cell a world location falls into */
+static FIntPoint GetCell(const FVector& Location, float CellSize)
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+bool FArchigramMemoryTracker::IsArchigramActor(const AActor* Actor)
+{
+	// Parked by "Clear Layout": kept for reuse, not part of the layout, so it doesn't count against the budget
+	if (!Actor || Actor->ActorHasTag(ArchigramParkedActorTag))
+	{
+		return false;
+	}
+
+	for (const FName& Tag : Actor->Tags)
+	{
+		if (Tag.ToString().StartsWith(ArchigramGenerationKeyTagPrefix))
+		{
+			return true;
+		}
+	}
+
+#if WITH_EDITOR
+	const FName FolderPath = Actor->GetFolderPath();
+	if (FolderPath == ArchigramOutlinerFolderName || FolderPath.ToString().StartsWith(ArchigramOutlinerFolderName.ToString() + TEXT("/")))
+	{
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+FArchigramActorMemory FArchigramMemoryTracker::MeasureActor(AActor* Actor)
+{
+	FArchigramActorMemory Memory;
+	if (!Actor)
+	{
+		return Memory;
+	}
+
+	Memory.Actor = Actor;
+	Memory.ActorName = Actor->GetName();
+	Memory.ActorBytes = Actor->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+	const float CellSize = FMath::Max(CVarArchigramMemoryCellSize.GetValueOnAnyThread(), 1.0f);
+	Memory.Cell = GetCell(Actor->GetActorLocation(), CellSize);
+
+	// Bytes already placed in the cells of individual instances
+	SIZE_T InstanceCellBytes = 0;
+
+	TSet<UStaticMesh*> CountedMeshes;
+
+	TInlineComponentArray<UActorComponent*> Components;
+	Actor->GetComponents(Components);
+
+	for (UActorComponent* Component : Components)
+	{
+		SIZE_T ComponentBytes = Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+		if (UInstancedStaticMeshComponent* ISMComponent = Cast<UInstancedStaticMeshComponent>(Component))
+		{
+			// Instance buffers are reported on their own, not as part of the component
+			const SIZE_T InstanceBytes = ISMComponent->PerInstanceSMData.GetAllocatedSize() + ISMComponent->PerInstanceSMCustomData.GetAllocatedSize();
+			Memory.InstanceBytes += InstanceBytes;
+			ComponentBytes -= FMath::Min(ComponentBytes, InstanceBytes);
+
+			// The component's resource size includes its instance bodies too; they are reported as collision
+			const int32 NumBodies = ISMComponent->InstanceBodies.Num();
+			const SIZE_T BodyBytes = NumBodies * sizeof(FBodyInstance);
+			Memory.CollisionBytes += BodyBytes;
+			ComponentBytes -= FMath::Min(ComponentBytes, BodyBytes);
+
+			// Generated instances spread over many cells: charge each instance's data and body to the cell it is in
+			const int32 NumInstances = ISMComponent->GetInstanceCount();
+			for (int32 InstanceIndex = 0; InstanceIndex < NumInstances; ++InstanceIndex)
+			{
+				FTransform InstanceTransform;
+				ISMComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
+
+				SIZE_T Bytes = InstanceBytes / NumInstances + ((SIZE_T)InstanceIndex < InstanceBytes % NumInstances ? 1 : 0);
+				if (InstanceIndex < NumBodies)
+				{
+					Bytes += sizeof(FBodyInstance);
+				}
+
+				Memory.CellBytes.FindOrAdd(GetCell(InstanceTransform.GetLocation(), CellSize)) += Bytes;
+				InstanceCellBytes += Bytes;
+			}
+		}
+
+		if (UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component))
+		{
+			UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
+			if (Mesh && !CountedMeshes.Contains(Mesh))
+			{
+				CountedMeshes.Add(Mesh);
+				Memory.MeshBytes += GetMeshBytes(Mesh);
+				Memory.CollisionBytes += GetBodySetupBytes(Mesh);
+			}
+		}
+
+		Memory.ComponentBytes += ComponentBytes;
+	}
+
+	// Meshes, body setups, components and the actor itself stay in the actor's cell
+	Memory.CellBytes.FindOrAdd(Memory.Cell) += Memory.GetTotalBytes() - InstanceCellBytes;
+
+	return Memory;
+}	// end of MeasureActor
+
+FArchigramMemoryReport FArchigramMemoryTracker::BuildReport(UWorld* World, AActor* ExcludedActor)
+{
+	FArchigramMemoryReport Report;
+	Report.BudgetBytes = (SIZE_T)FMath::Max(CVarArchigramMemoryBudgetMB.GetValueOnAnyThread(), 0) * 1024 * 1024;
+
+	if (!World)
+	{
+		return Report;
+	}
+
+	// Meshes are shared between actors: attribute them to each actor, but count them once in the totals
+	TSet<UStaticMesh*> CountedMeshes;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AActor* Actor = *It;
+		if (Actor == ExcludedActor || !IsArchigramActor(Actor))
+		{
+			continue;
+		}
+
+		FArchigramActorMemory& Memory = Report.Actors.Add_GetRef(MeasureActor(Actor));
+
+		// Mesh and body setup bytes of meshes an earlier actor was already charged for
+		SIZE_T SharedMeshBytes = 0;
+		TInlineComponentArray<UStaticMeshComponent*> MeshComponents;
+		Actor->GetComponents(MeshComponents);
+
+		TSet<UStaticMesh*> ActorMeshes;
+		for (UStaticMeshComponent* MeshComponent : MeshComponents)
+		{
+			UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
+			if (Mesh && !ActorMeshes.Contains(Mesh))
+			{
+				ActorMeshes.Add(Mesh);
+				if (CountedMeshes.Contains(Mesh))
+				{
+					SharedMeshBytes += GetMeshBytes(Mesh) + GetBodySetupBytes(Mesh);
+				}
+				CountedMeshes.Add(Mesh);
+			}
+		}
+
+		const SIZE_T ActorTotal = Memory.GetTotalBytes();
+		Report.TotalBytes += ActorTotal - FMath::Min(ActorTotal, SharedMeshBytes);
+
+		for (const TPair<FIntPoint, SIZE_T>& Cell : Memory.CellBytes)
+		{
+			Report.CellBytes.FindOrAdd(Cell.Key) += Cell.Value;
+		}
+
+		// Shared meshes were placed in the actor's cell, so that is where they are taken out again
+		SIZE_T& ActorCellBytes = Report.CellBytes.FindOrAdd(Memory.Cell);
+		ActorCellBytes -= FMath::Min(ActorCellBytes, SharedMeshBytes);
+	}
+
+	Report.Actors.Sort([](const FArchigramActorMemory& A, const FArchigramActorMemory& B) { return A.GetTotalBytes() > B.GetTotalBytes(); });
+
+	return Report;
+}	// end of BuildReport
+
+bool FArchigramMemoryTracker::CheckBudget(UWorld* World, AActor* ExcludedActor)
+{
+	if (CVarArchigramMemoryBudgetMB.GetValueOnGameThread() <= 0)
+	{
+		return true;
+	}
+
+	const FArchigramMemoryReport Report = BuildReport(World, ExcludedActor);
+	if (!Report.IsOverBudget())
+	{
+		return true;
+	}
+
+	const bool bRefuse = CVarArchigramMemoryRefuseOverBudget.GetValueOnGameThread() != 0;
+	UE_LOG(LogTemp, Warning, TEXT("Archigram: Generated content uses %.2f MB, over the %.2f MB budget%s"),
+		Report.TotalBytes / BytesPerMB, Report.BudgetBytes / BytesPerMB, bRefuse ? TEXT(" - refusing generation") : TEXT(""));
+
+	return !bRefuse;
+}
+
+FString FArchigramMemoryReport::ToString() const
+{
+	FString Result = FString::Printf(TEXT("Archigram memory: %.2f MB in %d actors"), TotalBytes / BytesPerMB, Actors.Num());
+	if (BudgetBytes > 0)
+	{
+		Result += FString::Printf(TEXT(" (budget %.2f MB%s)"), BudgetBytes / BytesPerMB, IsOverBudget() ? TEXT(", OVER BUDGET") : TEXT(""));
+	}
+	Result += TEXT("\n");
+
+	Result += FString::Printf(TEXT("%-40s %10s %10s %10s %10s %10s %10s\n"),
+		TEXT("Actor"), TEXT("Total MB"), TEXT("Mesh"), TEXT("Instances"), TEXT("Collision"), TEXT("Components"), TEXT("Actor"));
+
+	for (const FArchigramActorMemory& Memory : Actors)
+	{
+		Result += FString::Printf(TEXT("%-40s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n"),
+			*Memory.ActorName,
+			Memory.GetTotalBytes() / BytesPerMB,
+			Memory.MeshBytes / BytesPerMB,
+			Memory.InstanceBytes / BytesPerMB,
+			Memory.CollisionBytes / BytesPerMB,
+			Memory.ComponentBytes / BytesPerMB,
+			Memory.ActorBytes / BytesPerMB);
+	}
+
+	for (const TPair<FIntPoint, SIZE_T>& Cell : CellBytes)
+	{
+		Result += FString::Printf(TEXT("Cell (%d, %d): %.2f MB\n"), Cell.Key.X, Cell.Key.Y, Cell.Value / BytesPerMB);
+	}
+
+	return Result;
+}	// end of ToString
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice ArchigramMemReportCommand(
+	TEXT("Archigram.MemReport"),
+	TEXT("Prints the memory attributed to each generated Archigram actor and layout cell of the current world."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const FArchigramMemoryReport Report = FArchigramMemoryTracker::BuildReport(World);
+
+		TArray<FString> Lines;
+		Report.ToString().ParseIntoArrayLines(Lines);
+		for (const FString& Line : Lines)
+		{
+			Ar.Log(Line);
+		}
+	})
+);
+
+#pragma endregion
@@ -1,9 +1,19 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ArchigramRuntime.h"
+#include "ArchigramNames.h"
 
 #define LOCTEXT_NAMESPACE "FArchigramRuntimeModule"
 
+// Folder name in World Outliner for Archigram actors
+const FName ArchigramOutlinerFolderName = FName(TEXT("Archigram"));
+
+// Actor tag marking layout actors parked in the actor pool
+const FName ArchigramParkedActorTag = FName(TEXT("ArchigramParked"));
+
+// Actor tag prefix recording the cache key of the current layout
+const TCHAR* ArchigramGenerationKeyTagPrefix = TEXT("ArchigramGenerationKey=");
+
 void FArchigramRuntimeModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
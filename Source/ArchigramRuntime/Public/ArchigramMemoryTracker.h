@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AActor;
+class UWorld;
+
+/** Memory attributed to one Archigram actor, split by category */
+struct ARCHIGRAMRUNTIME_API FArchigramActorMemory
+{
+	TWeakObjectPtr<AActor> Actor;
+	FString ActorName;
+
+	/** Layout cell the actor's location falls into (see archigram.Memory.CellSize) */
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	/**
+	 * Bytes per layout cell: instance data and instance bodies go to the cell each instance is in,
+	 * everything else to the actor's cell. Sums to GetTotalBytes().
+	 */
+	TMap<FIntPoint, SIZE_T> CellBytes;
+
+	/** Static meshes referenced by the actor, each counted once */
+	SIZE_T MeshBytes = 0;
+
+	/** Per-instance data of instanced static mesh components */
+	SIZE_T InstanceBytes = 0;
+
+	/** Collision: mesh body setups and per-instance physics bodies */
+	SIZE_T CollisionBytes = 0;
+
+	/** Components themselves, excluding their instance data and instance bodies */
+	SIZE_T ComponentBytes = 0;
+
+	/** The actor object itself */
+	SIZE_T ActorBytes = 0;
+
+	SIZE_T GetTotalBytes() const { return MeshBytes + InstanceBytes + CollisionBytes + ComponentBytes + ActorBytes; }
+};
+
+/** Memory of every Archigram actor in a world, with per-cell totals */
+struct ARCHIGRAMRUNTIME_API FArchigramMemoryReport
+{
+	TArray<FArchigramActorMemory> Actors;
+
+	/** Per-cell totals; meshes shared by several actors are counted once, so the cells sum to TotalBytes */
+	TMap<FIntPoint, SIZE_T> CellBytes;
+
+	/** Total over all actors; meshes shared by several actors are counted once */
+	SIZE_T TotalBytes = 0;
+
+	/** Configured budget in bytes, 0 when no budget is set */
+	SIZE_T BudgetBytes = 0;
+
+	bool IsOverBudget() const { return BudgetBytes > 0 && TotalBytes > BudgetBytes; }
+
+	/** Human readable table, one line per actor and per cell */
+	FString ToString() const;
+};
+
+/**
+ * Attributes mesh, instance buffer, collision, component and actor memory to Archigram actors
+ * and enforces the budget configured with archigram.Memory.BudgetMB.
+ * Console: Archigram.MemReport prints the report of the current world.
+ */
+class ARCHIGRAMRUNTIME_API FArchigramMemoryTracker
+{
+public:
+	/**
+	 * True for actors produced by Archigram (generation key tag, or Archigram outliner folder in the editor).
+	 * Actors parked in the pool by "Clear Layout" are not part of any layout and are left out.
+	 */
+	static bool IsArchigramActor(const AActor* Actor);
+
+	/** Measures a single actor */
+	static FArchigramActorMemory MeasureActor(AActor* Actor);
+
+	/**
+	 * Measures every Archigram actor of the world.
+	 * @param ExcludedActor - Actor left out of the report (e.g. one about to be regenerated)
+	 */
+	static FArchigramMemoryReport BuildReport(UWorld* World, AActor* ExcludedActor = nullptr);
+
+	/**
+	 * Checks the world's Archigram content against the budget, before a new generation or after one finished.
+	 * Logs a warning when over budget.
+	 * @param ExcludedActor - Actor whose current content doesn't count (its layout is about to be replaced)
+	 * @return False if over budget and archigram.Memory.RefuseOverBudget is set, i.e. generation must not run
+	 */
+	static bool CheckBudget(UWorld* World, AActor* ExcludedActor = nullptr);
+};
@@ -0,0 +1,14 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Folder name in World Outliner for Archigram actors */
+extern ARCHIGRAMRUNTIME_API const FName ArchigramOutlinerFolderName;
+
+/** Actor tag marking a layout actor parked by "Clear Layout" in the Archigram actor pool (saved with the level) */
+extern ARCHIGRAMRUNTIME_API const FName ArchigramParkedActorTag;
+
+/** Actor tag prefix recording the cache key of the inputs an Archigram layout was generated from */
+extern ARCHIGRAMRUNTIME_API const TCHAR* ArchigramGenerationKeyTagPrefix;